@@ -0,0 +1,99 @@
+#include "main.h"
+
+#define ARENA_FIRST_CHUNK 4096
+#define ARENA_ALIGN sizeof(void *)
+
+static arena_t line_arena;
+
+/**
+ * arenaChunk - gets a chunk with room for size bytes after cur
+ * @size: bytes needed
+ *
+ * Description: chunks kept from earlier lines are reused in order; a new
+ * chunk is at least twice as large as the last one, so a line needs only
+ * O(log n) chunk allocations and later lines of the same size none.
+ *
+ * Return: the chunk, now line_arena.cur, NULL on malloc failure
+ */
+static arena_chunk_t *arenaChunk(size_t size)
+{
+	arena_chunk_t *chunk = line_arena.cur, *next;
+	size_t chunk_size;
+
+	while (chunk != NULL && chunk->next != NULL) /* kept from an earlier line */
+	{
+		chunk = chunk->next;
+		chunk->used = 0;
+		line_arena.cur = chunk;
+		if (chunk->size >= size)
+			return (chunk);
+	}
+
+	chunk_size = chunk ? chunk->size * 2 : ARENA_FIRST_CHUNK;
+	while (chunk_size < size)
+		chunk_size *= 2;
+	next = malloc(sizeof(arena_chunk_t) + chunk_size);
+	if (next == NULL)
+		return (NULL);
+	next->next = NULL;
+	next->size = chunk_size;
+	next->used = 0;
+	if (chunk != NULL)
+		chunk->next = next;
+	else
+		line_arena.first = next;
+	line_arena.cur = next;
+	return (next);
+}
+
+/**
+ * arenaAlloc - allocates memory that lives until the next arenaReset()
+ * @size: number of bytes
+ *
+ * Return: zeroed memory aligned for any pointer or size_t,
+ * NULL on malloc failure
+ */
+void *arenaAlloc(size_t size)
+{
+	arena_chunk_t *chunk = line_arena.cur;
+	void *mem;
+
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+	if (chunk == NULL || chunk->size - chunk->used < size)
+	{
+		chunk = arenaChunk(size);
+		if (chunk == NULL)
+			return (NULL);
+	}
+	mem = chunk->data + chunk->used;
+	chunk->used += size;
+	memset(mem, 0, size);
+	return (mem);
+}
+
+/**
+ * arenaReset - frees everything arenaAlloc() returned, in O(1); the
+ * chunks are kept for the next line
+ */
+void arenaReset(void)
+{
+	line_arena.cur = line_arena.first;
+	if (line_arena.cur != NULL)
+		line_arena.cur->used = 0;
+}
+
+/**
+ * arenaDestroy - returns every chunk to malloc
+ */
+void arenaDestroy(void)
+{
+	arena_chunk_t *chunk;
+
+	while (line_arena.first != NULL)
+	{
+		chunk = line_arena.first;
+		line_arena.first = chunk->next;
+		free(chunk);
+	}
+	line_arena.cur = NULL;
+}
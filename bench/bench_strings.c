@@ -0,0 +1,242 @@
+#include "../main.h"
+#include <sys/mman.h>
+#include <time.h>
+
+/*
+ * Micro-benchmark for the string kernels in string_kernels.c.
+ *
+ * First checks every level against the scalar one, including strings that
+ * end right before an unmapped page, then times each level on a long
+ * command line and on a big environment.
+ */
+
+#define LINE_LEN (64 * 1024)
+#define ENV_COUNT 4096
+
+static const char *const level_names[] = {"scalar", "swar", "sse2", "avx2"};
+
+/**
+ * now_ns - monotonic clock
+ *
+ * Return: nanoseconds
+ */
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+/**
+ * check_level - compares one level with the scalar kernels
+ * @level: level to check
+ *
+ * Description: strings are placed at every offset so that they end at a
+ * page whose successor is PROT_NONE; an overread past the page faults.
+ *
+ * Return: number of mismatches
+ */
+static int check_level(str_level_t level)
+{
+	static const char *const rejects[] = {"", "|", " \t", " \t|&;<>",
+										  "abcdefghijklmnopq"};
+	size_t page = sysconf(_SC_PAGESIZE), len, off, k, ref_n, n;
+	char *map, *end, *s, *t;
+	const char *ref_p;
+	int errors = 0, ref_c, c;
+
+	map = mmap(NULL, page * 2, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (map == MAP_FAILED)
+		return (1);
+	mprotect(map + page, page, PROT_NONE);
+	end = map + page;
+	t = malloc(page);
+
+	for (len = 0; len < 200; len++)
+	{
+		for (off = 0; off < 64 && off + len + 1 <= page; off++)
+		{
+			s = end - len - 1 - off; /* NUL lands off bytes before the guard */
+			for (k = 0; k < len; k++)
+				s[k] = 'a' + (k * 7 + off) % 26;
+			s[len] = '\0';
+			memcpy(t, s, len + 1);
+
+			strKernelSelect(STR_SCALAR);
+			ref_n = strScanLen(s);
+			ref_p = strScanChr(s, 'q');
+			ref_c = strScanCmp(s, t);
+			strKernelSelect(level);
+			if (strScanLen(s) != ref_n || strScanChr(s, 'q') != ref_p)
+				errors++;
+			if ((strScanCmp(s, t) == 0) != (ref_c == 0) ||
+				(strScanCmp(t, s) == 0) != (ref_c == 0))
+				errors++;
+			if (len > 0)
+			{
+				t[len - 1]++; /* differ in the last byte */
+				strKernelSelect(STR_SCALAR);
+				ref_c = strScanCmp(s, t);
+				strKernelSelect(level);
+				c = strScanCmp(s, t);
+				if ((c < 0) != (ref_c < 0) || (c == 0) != (ref_c == 0))
+					errors++;
+				t[len - 1]--;
+			}
+			for (k = 0; k < sizeof(rejects) / sizeof(rejects[0]); k++)
+			{
+				strKernelSelect(STR_SCALAR);
+				ref_n = strScanCspn(s, rejects[k]);
+				strKernelSelect(level);
+				n = strScanCspn(s, rejects[k]);
+				if (n != ref_n)
+					errors++;
+			}
+		}
+	}
+	free(t);
+	munmap(map, page * 2);
+	return (errors);
+}
+
+/**
+ * build_line - fills a long command line of short words and operators
+ * @line: buffer of LINE_LEN + 1 bytes
+ */
+static void build_line(char *line)
+{
+	static const char *const words[] = {"ls", "-la", "|", "grep", "foo",
+										"&&", "echo", "done", ";"};
+	size_t pos = 0, w = 0, len;
+
+	while (1)
+	{
+		len = strlen(words[w]);
+		if (pos + len + 1 >= LINE_LEN)
+			break;
+		memcpy(line + pos, words[w], len);
+		pos += len;
+		line[pos++] = ' ';
+		w = (w + 1) % (sizeof(words) / sizeof(words[0]));
+	}
+	line[pos - 1] = '>'; /* the only '>' is at the very end */
+	line[pos] = '\0';
+}
+
+/**
+ * bench_level - times the kernels of one level
+ * @level: level
+ * @line: long command line
+ * @env: environment of ENV_COUNT entries
+ * @results: set to ns per operation for each benchmark
+ */
+static void bench_level(str_level_t level, char *line, char **env,
+						double *results)
+{
+	volatile size_t sink = 0;
+	double t0;
+	int i, rounds = 200, j;
+	const char *p;
+
+	strKernelSelect(level);
+
+	t0 = now_ns();
+	for (i = 0; i < rounds; i++)
+		sink += _strlen(line);
+	results[0] = (now_ns() - t0) / rounds;
+
+	t0 = now_ns();
+	for (i = 0; i < rounds; i++)
+		sink += (size_t)_strchr(line, '>');
+	results[1] = (now_ns() - t0) / rounds;
+
+	t0 = now_ns();
+	for (i = 0; i < rounds; i++) /* split the whole line into words */
+	{
+		for (p = line; *p; p++)
+			p += _strcspn(p, " \t|&;<>");
+		sink += (size_t)p;
+	}
+	results[2] = (now_ns() - t0) / rounds;
+
+	t0 = now_ns();
+	for (i = 0; i < rounds; i++) /* one long span: no newline in the line */
+		sink += _strcspn(line, "\n#");
+	results[5] = (now_ns() - t0) / rounds;
+
+	t0 = now_ns();
+	for (i = 0; i < rounds; i++)
+		sink += (size_t)_strstr(line, "done >");
+	results[3] = (now_ns() - t0) / rounds;
+
+	t0 = now_ns();
+	for (i = 0; i < rounds; i++) /* linear getenv of the last name */
+		for (j = 0; j < ENV_COUNT; j++)
+			sink += _strcmp(env[j], env[ENV_COUNT - 1]) == 0;
+	results[4] = (now_ns() - t0) / rounds;
+	(void)sink;
+}
+
+/**
+ * main - checks, then benchmarks every available level
+ *
+ * Return: 0 if every level matches the scalar kernels, 1 otherwise
+ */
+int main(void)
+{
+	static const char *const names[] = {"strlen 64K line", "strchr 64K line",
+										"strcspn split line",
+										"strstr 64K line",
+										"strcmp 4096 env",
+										"strcspn 64K span"};
+	double results[4][6];
+	char *line = malloc(LINE_LEN + 1), **env = malloc(sizeof(char *) * ENV_COUNT);
+	int level, i, failed = 0, have[4] = {0};
+
+	if (line == NULL || env == NULL)
+		return (1);
+	build_line(line);
+	for (i = 0; i < ENV_COUNT; i++) /* long common prefixes, like real envs */
+	{
+		env[i] = malloc(96);
+		snprintf(env[i], 96, "HSH_BENCH_VARIABLE_WITH_A_LONG_NAME_%06d=%s", i,
+				 "/usr/local/bin:/usr/bin:/bin");
+	}
+
+	for (level = STR_SCALAR; level <= STR_AVX2; level++)
+	{
+		if (strKernelSelect(level) == -1)
+			continue;
+		have[level] = 1;
+		i = check_level(level);
+		printf("check %-6s %s\n", level_names[level], i ? "FAILED" : "ok");
+		failed |= i != 0;
+	}
+
+	for (level = STR_SCALAR; level <= STR_AVX2; level++)
+		if (have[level])
+			bench_level(level, line, env, results[level]);
+
+	printf("\n%-20s", "ns/op");
+	for (level = STR_SCALAR; level <= STR_AVX2; level++)
+		if (have[level])
+			printf("%16s", level_names[level]);
+	printf("\n");
+	for (i = 0; i < 6; i++)
+	{
+		printf("%-20s", names[i]);
+		for (level = STR_SCALAR; level <= STR_AVX2; level++)
+			if (have[level])
+				printf("%9.0f (%4.1fx)", results[level][i],
+					   results[STR_SCALAR][i] / results[level][i]);
+		printf("\n");
+	}
+
+	for (i = 0; i < ENV_COUNT; i++)
+		free(env[i]);
+	free(env);
+	free(line);
+	return (failed);
+}
@@ -0,0 +1,281 @@
+#include "main.h"
+
+#define CMD_HASH_BUCKETS 64
+#define CMD_MISS_SLOTS 32
+
+static cmd_hash_t *cmd_hash_table[CMD_HASH_BUCKETS];
+static cmd_miss_t cmd_miss_table[CMD_MISS_SLOTS];
+static cmd_hash_stats_t cmd_hash_stats;
+
+/**
+ * hashName - djb2 hash of a command name
+ * @name: command name
+ *
+ * Return: bucket index for name
+ */
+static unsigned int hashName(const char *name)
+{
+	unsigned long hash = 5381;
+
+	while (*name)
+		hash = ((hash << 5) + hash) + (unsigned char)*name++;
+	return (hash % CMD_HASH_BUCKETS);
+}
+
+/**
+ * missSlot - direct-mapped negative cache slot for a command name
+ * @name: command name
+ *
+ * Return: the one slot name may live in
+ */
+static cmd_miss_t *missSlot(const char *name)
+{
+	return (&cmd_miss_table[hashName(name) % CMD_MISS_SLOTS]);
+}
+
+/**
+ * hashFind - finds a command's node
+ * @name: command name
+ *
+ * Return: the node, NULL if name is not remembered
+ */
+static cmd_hash_t *hashFind(const char *name)
+{
+	cmd_hash_t *node;
+
+	for (node = cmd_hash_table[hashName(name)]; node; node = node->next)
+		if (_strcmp(node->name, name) == 0)
+			return (node);
+	return (NULL);
+}
+
+/**
+ * hashLookup - looks up a command's remembered absolute path without
+ * counting a hit, e.g. to tell whether it is a command at all
+ * @name: command name, as typed by the user
+ *
+ * Return: cached path (owned by the table, do not free), NULL if unknown
+ */
+char *hashLookup(const char *name)
+{
+	cmd_hash_t *node = hashFind(name);
+
+	return (node != NULL ? node->path : NULL);
+}
+
+/**
+ * hashHit - looks up the path of a command about to be run, counting
+ * the hit that "hash" reports
+ * @name: command name, as typed by the user
+ *
+ * Return: cached path (owned by the table, do not free), NULL if unknown
+ */
+char *hashHit(const char *name)
+{
+	cmd_hash_t *node = hashFind(name);
+
+	if (node == NULL)
+		return (NULL);
+	node->hits++;
+	cmd_hash_stats.hits++;
+	return (node->path);
+}
+
+/**
+ * hashInsert - remembers the absolute path of a command
+ * @name: command name
+ * @path: absolute path that name resolved to
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+int hashInsert(const char *name, const char *path)
+{
+	unsigned int bucket = hashName(name);
+	cmd_hash_t *node;
+	char *path_copy = _strdup(path);
+
+	if (path_copy == NULL)
+		return (-1);
+	cmd_hash_stats.misses++; /* only called after walking PATH */
+
+	for (node = cmd_hash_table[bucket]; node; node = node->next)
+	{
+		if (_strcmp(node->name, name) == 0) /* replace stale entry */
+		{
+			free(node->path);
+			node->path = path_copy;
+			node->hits = 0;
+			return (0);
+		}
+	}
+
+	node = malloc(sizeof(cmd_hash_t));
+	if (node == NULL)
+	{
+		free(path_copy);
+		return (-1);
+	}
+	node->name = _strdup(name);
+	if (node->name == NULL)
+	{
+		free(path_copy);
+		free(node);
+		return (-1);
+	}
+	node->path = path_copy;
+	node->hits = 0;
+	node->next = cmd_hash_table[bucket];
+	cmd_hash_table[bucket] = node;
+	return (0);
+}
+
+/**
+ * hashRemove - forgets a single command, e.g. after its binary vanished
+ * @name: command name
+ */
+void hashRemove(const char *name)
+{
+	cmd_hash_t **link = &cmd_hash_table[hashName(name)];
+	cmd_hash_t *node;
+
+	for (node = *link; node; link = &node->next, node = node->next)
+	{
+		if (_strcmp(node->name, name) == 0)
+		{
+			*link = node->next;
+			cmd_hash_stats.evictions++;
+			free(node->name);
+			free(node->path);
+			free(node);
+			return;
+		}
+	}
+}
+
+/**
+ * hashClear - forgets every remembered command (PATH changed or exiting)
+ */
+void hashClear(void)
+{
+	cmd_hash_t *node, *next;
+	int i;
+
+	for (i = 0; i < CMD_HASH_BUCKETS; i++)
+	{
+		for (node = cmd_hash_table[i]; node; node = next)
+		{
+			next = node->next;
+			cmd_hash_stats.evictions++;
+			free(node->name);
+			free(node->path);
+			free(node);
+		}
+		cmd_hash_table[i] = NULL;
+	}
+}
+
+/**
+ * missLookup - checks whether name is already known not to exist
+ * @name: command name
+ * @generation: current PATH generation
+ * @dir_epoch: current PATH directory mtime epoch
+ *
+ * Return: 1 if name was not found under the same PATH and directory
+ * contents, 0 if PATH has to be searched
+ */
+int missLookup(const char *name, unsigned long generation,
+			   unsigned long dir_epoch)
+{
+	cmd_miss_t *slot = missSlot(name);
+
+	if (slot->name != NULL && slot->generation == generation &&
+		slot->dir_epoch == dir_epoch && _strcmp(slot->name, name) == 0)
+	{
+		cmd_hash_stats.negative_hits++;
+		return (1);
+	}
+	return (0);
+}
+
+/**
+ * missInsert - remembers that name was not found, evicting whatever
+ * other name shared its slot so the cache stays bounded
+ * @name: command name
+ * @generation: PATH generation searched
+ * @dir_epoch: PATH directory mtime epoch taken before the search
+ */
+void missInsert(const char *name, unsigned long generation,
+				unsigned long dir_epoch)
+{
+	cmd_miss_t *slot = missSlot(name);
+
+	cmd_hash_stats.misses++;
+	if (slot->name == NULL || _strcmp(slot->name, name) != 0)
+	{
+		free(slot->name);
+		slot->name = _strdup(name);
+	}
+	slot->generation = generation;
+	slot->dir_epoch = dir_epoch;
+}
+
+/**
+ * missRemove - forgets that name was not found
+ * @name: command name
+ */
+void missRemove(const char *name)
+{
+	cmd_miss_t *slot = missSlot(name);
+
+	if (slot->name != NULL && _strcmp(slot->name, name) == 0)
+	{
+		free(slot->name);
+		slot->name = NULL;
+	}
+}
+
+/**
+ * missClear - forgets every remembered "not found" result
+ */
+void missClear(void)
+{
+	int i;
+
+	for (i = 0; i < CMD_MISS_SLOTS; i++)
+	{
+		free(cmd_miss_table[i].name);
+		cmd_miss_table[i].name = NULL;
+	}
+}
+
+/**
+ * hashPrint - lists remembered commands the way bash's "hash" does
+ */
+void hashPrint(void)
+{
+	cmd_hash_t *node;
+	int i, empty = 1;
+
+	for (i = 0; i < CMD_HASH_BUCKETS; i++)
+	{
+		for (node = cmd_hash_table[i]; node; node = node->next)
+		{
+			if (empty)
+				printf("hits\tcommand\n");
+			empty = 0;
+			printf("%4u\t%s\n", node->hits, node->path);
+		}
+	}
+	if (empty)
+		printf("hash: hash table empty\n");
+}
+
+/**
+ * hashStats - returns the command resolution counters
+ *
+ * Return: pointer to the counters
+ */
+cmd_hash_stats_t *hashStats(void)
+{
+	return (&cmd_hash_stats);
+}
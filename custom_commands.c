@@ -1,5 +1,34 @@
 #include "main.h"
 
+/* every builtin, looked up by name before PATH is searched */
+static const builtin_t builtins[] = {
+	{"cd", ifCmdCd},
+	{"env", ifCmdEnv},
+	{"exit", ifCmdExit},
+	{"hash", ifCmdHash},
+	{"quit", ifCmdExit},
+	{"self-destruct", ifCmdSelfDestruct},
+	{"selfdestr", ifCmdSelfDestruct},
+	{"setenv", ifCmdSetEnv},
+	{"unsetenv", ifCmdUnsetEnv},
+	{NULL, NULL}};
+
+/**
+ * builtinFind - looks a command name up in the builtin table
+ * @name: command name
+ *
+ * Return: the builtin, NULL if name is not one
+ */
+const builtin_t *builtinFind(const char *name)
+{
+	const builtin_t *b;
+
+	for (b = builtins; b->name != NULL; b++)
+		if (_strcmp(b->name, name) == 0)
+			return (b);
+	return (NULL);
+}
+
 /**
  * customCmd - check if the given input is a custom command. If so, executes it
  *
@@ -7,48 +36,48 @@
  * @interactive: if the shell is running in interactive mode (isAtty)
  *
  * Return: 1 if it was a custom command and it was successfully executed,
- * 0 if it's not a custom command,
+ * 0 if it's not a custom command, 2 or 3 for cd errors (see builtinStatus),
  * -1 on error
  */
-int customCmd(char **tokens, int interactive, char *input)
+int customCmd(char **tokens, int interactive)
 {
-	int ifRtn;
-	/* ------------------ custom command "env" ------------------ */
-	if (ifCmdEnv(tokens))
-		return (1); /* might convert all returns to function return values */
-
-	/* ----------------- custom command "exit" ----------------- */
-
-	if (ifCmdExit(tokens, interactive, input)) /* exits with or without exit code*/
-		return (1);							   /* now it returns 1, if it exits */
-
-	/* ----------------- custom command "setenv" ----------------- */
-	if (ifCmdSetEnv(tokens))
-		return (1);
-
-	/* ----------------- custom command "unsetenv" ----------------- */
-	if (ifCmdUnsetEnv(tokens))
-		return (1);
-
-	/* ------------- custom command "self-destruct" ------------- */
-	if (ifCmdSelfDestruct(tokens) == -1)
-		return (-1);
-
-	/* ----------------- custom command "cd" ----------------- */
-	ifRtn = ifCmdCd(tokens);
-	if (ifRtn)
-		return (ifRtn);
+	const builtin_t *b;
+
+	if (tokens[0] == NULL)
+		return (0);
+	b = builtinFind(tokens[0]);
+	if (b == NULL)
+		return (0); /* indicate that the input is not a custom command */
+	return (b->run(tokens, interactive));
+}
 
-	return (0); /* indicate that the input is not a custom command */
+/**
+ * builtinStatus - turns what a builtin returned into its exit status,
+ * reporting the errors it left to its caller
+ * @rtn: the builtin's return value, as from customCmd()
+ * @tokens: the builtin's argv
+ *
+ * Return: 0 if it succeeded, 2 otherwise
+ */
+int builtinStatus(int rtn, char **tokens)
+{
+	if (rtn == 2) /* false directory */
+		fprintf(stderr, "%s: 1: cd: can't cd to %s\n", shellName(),
+				tokens[1]);
+	else if (rtn == 3) /* too many arguments */
+		fprintf(stderr, "%s: 1: cd: too many arguments\n", shellName());
+	return (rtn == 1 ? 0 : 2);
 }
 
 /**
  * ifCmdSelfDestruct - self destruct oscar mike golf
  * @tokens: tokenized array of user-inputs
+ * @interactive: unused, for the builtin table
  * Return: 0 if successful, -1 otherwise
  */
-int ifCmdSelfDestruct(char **tokens)
+int ifCmdSelfDestruct(char **tokens, int interactive)
 {
+	(void)interactive;
 	if (tokens[0] != NULL && (_strcmp(tokens[0], "self-destruct") == 0 ||
 							  _strcmp(tokens[0], "selfdestr") == 0))
 	{
@@ -74,7 +103,7 @@ int ifCmdSelfDestruct(char **tokens)
  *
  * Return: 0 if the command isn't "exit" or "quit"
  */
-int ifCmdExit(char **tokens, int interactive, char *input)
+int ifCmdExit(char **tokens, int interactive)
 {
 	int exit_code = EXIT_SUCCESS; // Default exit code
 
@@ -88,16 +117,15 @@ int ifCmdExit(char **tokens, int interactive, char *input)
 				exit_code = _atoi_safe(tokens[1]);
 				if (exit_code <= 0)
 				{
-					fprintf(stderr, "./hsh: 1: exit: Illegal number: %d\n",
-							exit_code);
+					fprintf(stderr, "%s: 1: exit: Illegal number: %d\n",
+							shellName(), exit_code);
 					exit_code = 2; // invalid number
 				}
 			}
 			else /* string */
 			{
-				fprintf(stderr, "./hsh: 1: exit: Illegal number: %s\n",
-						tokens[1]);
-				resetAll(tokens, input, NULL);
+				fprintf(stderr, "%s: 1: exit: Illegal number: %s\n",
+						shellName(), tokens[1]);
 				safeExit(2); /* exit with error if not number */
 			}
 		}
@@ -107,8 +135,6 @@ int ifCmdExit(char **tokens, int interactive, char *input)
 			printf("%s\nThe %sGates Of Shell%s have closed. Goodbye.\n%s",
 				   CLR_YELLOW_BOLD, CLR_RED_BOLD, CLR_YELLOW_BOLD, CLR_DEFAULT);
 		}
-		free(input);
-		free(tokens);
 		safeExit(exit_code); /* Exit with the determined code */
 		return 1;			 /* Should never reach here, but good practice */
 	}
@@ -119,37 +145,108 @@ int ifCmdExit(char **tokens, int interactive, char *input)
 /**
  * ifCmdEnv - prints env if the command is env
  * @tokens: tokenized user-input
+ * @interactive: unused, for the builtin table
  *
  * Return: 1 if success, 0 if failure
  */
-int ifCmdEnv(char **tokens)
+int ifCmdEnv(char **tokens, int interactive)
 {
+	char **envp;
 	int i;
 
+	(void)interactive;
 	if (tokens[0] != NULL && (_strcmp(tokens[0], "env") == 0))
 	{
-		if (!environ)
+		envp = envGetEnvp();
+		if (!envp)
 			return (1);
 
-		for (i = 0; environ[i] != NULL; i++)
-			printf("%s\n", environ[i]);
+		for (i = 0; envp[i] != NULL; i++)
+			printf("%s\n", envp[i]);
 		return (1); /* indicate success */
 	}
 	return (0); /* indicate that input is not "env" */
 }
 
+/**
+ * ifCmdHash - inspects and manages the command resolution cache
+ * @tokens: tokenized user-input
+ * @interactive: unused, for the builtin table
+ *
+ * Description: "hash" lists entries with hit counts, "hash -r" forgets
+ * everything, "hash -s" prints counters, "hash name..." looks each name
+ * up in PATH again and remembers it.
+ *
+ * Return: 1 if the command was hash, 0 otherwise, -1 after reporting an
+ * unknown option
+ */
+int ifCmdHash(char **tokens, int interactive)
+{
+	cmd_hash_stats_t *stats;
+	char *full_path;
+	int i;
+
+	(void)interactive;
+	if (tokens[0] == NULL || _strcmp(tokens[0], "hash") != 0)
+		return (0);
+
+	if (tokens[1] == NULL)
+		hashPrint();
+	else if (_strcmp(tokens[1], "-r") == 0)
+	{
+		hashClear();
+		missClear();
+	}
+	else if (_strcmp(tokens[1], "-s") == 0)
+	{
+		stats = hashStats();
+		printf("hits: %lu\nnegative hits: %lu\nmisses: %lu\nevictions: %lu\n",
+			   stats->hits, stats->negative_hits, stats->misses,
+			   stats->evictions);
+	}
+	else if (tokens[1][0] == '-')
+	{
+		fprintf(stderr, "%s: 1: hash: Illegal option %s\n", shellName(),
+				tokens[1]);
+		fprintf(stderr, "usage: hash [-r | -s | name ...]\n");
+		return (-1);
+	}
+	else
+	{
+		for (i = 1; tokens[i] != NULL; i++)
+		{
+			hashRemove(tokens[i]); /* prime: always search PATH again */
+			full_path = findPath(tokens[i]);
+			if (full_path == NULL)
+				fprintf(stderr, "%s: 1: hash: %s: not found\n", shellName(),
+						tokens[i]);
+			free(full_path);
+		}
+	}
+	return (1);
+}
+
 /**
  * ifCmdSetEnv - sets an environment variable
  * @tokens: tokenized user-inputed commands
+ * @interactive: unused, for the builtin table
  *
- * Return: 1 if success, 0 if not applicable, -1 if malloc failed
+ * Return: 1 if success, 0 if not applicable, -1 if malloc failed or
+ * after reporting a missing NAME or VALUE
  */
-int ifCmdSetEnv(char **tokens)
+int ifCmdSetEnv(char **tokens, int interactive)
 {
 	int rtn;
 
+	(void)interactive;
 	if (tokens[0] != NULL && (_strcmp(tokens[0], "setenv") == 0))
 	{
+		if (tokens[1] == NULL || tokens[2] == NULL) /* argv ends at NULL */
+		{
+			fprintf(stderr, "%s: 1: setenv: usage: setenv NAME VALUE\n",
+					shellName());
+			return (-1);
+		}
 		rtn = _setenv(tokens[1], tokens[2], 1);
 		if (rtn == -1) /* error occurred in _setenv */
 		{
@@ -166,35 +263,33 @@ int ifCmdSetEnv(char **tokens)
 /**
  * ifCmdCd - changes directory
  * @tokens: tokenized array of user-input
+ * @interactive: unused, for the builtin table
  *
  * Return: 1 if successful, 0 if not applicable, 3 too many arguments, otherwise error
  */
-int ifCmdCd(char **tokens)
+int ifCmdCd(char **tokens, int interactive)
 {
 	char cwd_buf[PATH_MAX], abs_path[PATH_MAX + 2];
-	char *previous_cwd = _getenv("OLDPWD"); /* track previous cwd for '-' handling */
+	char *previous_cwd; /* track previous cwd for '-' handling */
 	int chdir_rtn = 0, error_msg = 0;
-	char *home = _getenv("HOME");
-	char *pwd = _getenv("PWD");
+	char *home;
 
+	(void)interactive;
 	if (getcwd(cwd_buf, PATH_MAX) == NULL)
 	{
-		freeIfCmdCd(previous_cwd, home, pwd); /* frees malloc'd strings */
 		perror("getcwd");
 		return (-1);
 	}
 
-	if (!pwd) /* set PWD if not already set */
+	if (!_getenv("PWD")) /* set PWD if not already set */
 		_setenv("PWD", cwd_buf, 1);
-	else
-	{
-		free(pwd);
-		pwd = NULL;
-	}
+	/* borrowed from the store, so only look up after the _setenv above */
+	previous_cwd = _getenv("OLDPWD");
+	home = _getenv("HOME");
 
 	if ((tokens[0] != NULL) && (_strcmp(tokens[0], "cd") == 0)) /* cd command found */
 	{
-		if (tokens[2] != NULL) /* too many arguments */
+		if (tokens[1] != NULL && tokens[2] != NULL) /* too many args */
 			error_msg = 3;
 		else if (tokens[1] != NULL)
 		{
@@ -205,8 +300,6 @@ int ifCmdCd(char **tokens)
 					chdir_rtn = chdir(home);
 					if (chdir_rtn == -1)
 						error_msg = 1;
-					free(home);
-					home = NULL;
 				}
 				else
 					error_msg = 0;
@@ -219,8 +312,6 @@ int ifCmdCd(char **tokens)
 						printf("%s\n", _getenv("PWD"));
 					else
 						printf("%s\n", previous_cwd);
-					free(previous_cwd);
-					previous_cwd = NULL;
 				}
 				else
 					printf("%s\n", cwd_buf);
@@ -254,8 +345,6 @@ int ifCmdCd(char **tokens)
 			if (home)
 			{
 				chdir_rtn = chdir(home);
-				free(home);
-				home = NULL;
 			}
 			else
 				error_msg = 0;
@@ -265,7 +354,6 @@ int ifCmdCd(char **tokens)
 			if ((error_msg == 1) || (error_msg == 4))
 				printf("%s\n", cwd_buf);
 
-			freeIfCmdCd(previous_cwd, home, pwd);
 			if (chdir_rtn == -1)
 				return (-1);
 			if ((error_msg == 1) || (error_msg == 4))
@@ -282,7 +370,6 @@ int ifCmdCd(char **tokens)
 
 			if (getcwd(cwd_buf, PATH_MAX) == NULL)
 			{
-				freeIfCmdCd(previous_cwd, home, pwd);
 				perror("getcwd");
 				return (-1);
 			}
@@ -291,485 +378,8 @@ int ifCmdCd(char **tokens)
 	}
 	else
 	{
-		freeIfCmdCd(previous_cwd, home, pwd);
 		return (0); /* cd not applicable */
 	}
 
-	freeIfCmdCd(previous_cwd, home, pwd);
 	return (1); /* success */
 }
-
-int RightDirect(char *line)
-{
-	int fd, i = 0, j = 0, position = 0;
-	char *filename;
-	char *args[100];
-	int bufsize = 64;
-	char **tokens = malloc(bufsize * sizeof(char *));
-	char *token;
-
-	if (!tokens)
-	{ /* Stanard Malloc Error Handling */
-		fprintf(stderr, "hsh: allocation error\n");
-		exit(EXIT_FAILURE);
-	}
-	token = strtok(line, " \t\r\n\a"); /* Tokenize the input */
-	while (token != NULL)
-	{
-		char *marker = _strchr(token, '>'); /* Find the first occurrence of > and set it to variable marker */
-		if (marker)
-		{					/* If > is found in the input */
-			*marker = '\0'; /* Split the token at > */
-			if (*token != '\0')
-			{								/* If there is something before > */
-				tokens[position++] = token; /* Add the token before > */
-			}
-			tokens[position++] = ">"; /* Add > to the tokens */
-			if (*(marker + 1) != '\0')
-			{									 /* If there is something after > */
-				tokens[position++] = marker + 1; /* Get rid of the space */
-			}
-		}
-		else
-		{
-			tokens[position++] = token; /* Add the token to the tokens */
-		}
-		if (position >= bufsize)
-		{														/* If the buffer is full */
-			bufsize += 64;										/* Increase the buffer size */
-			tokens = realloc(tokens, bufsize * sizeof(char *)); /* Reallocate the buffer */
-			if (!tokens)
-			{
-				fprintf(stderr, "hsh: allocation error\n");
-				exit(EXIT_FAILURE);
-			}
-		}
-		token = strtok(NULL, " \t\r\n\a"); /* Get the next token */
-	}
-	tokens[position] = NULL; /* Add NULL to the end of the tokens */
-	while (tokens[i] != NULL)
-	{
-		if (_strcmp(tokens[i], ">") == 0)
-			break;			   /* If > is found in the tokens */
-		args[j++] = tokens[i]; /* Add the token to the args */
-		i++;
-	}
-	args[j] = NULL; /* Add NULL to the end of the args */
-	if (tokens[i] == NULL || tokens[i + 1] == NULL)
-	{ /* If there is no filename after > */
-		fprintf(stderr, "Syntax error: Missing filename after '>'\n");
-		free(tokens);
-		return -1;
-	}
-
-	filename = tokens[i + 1];								 /* Get the filename */
-	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644); /* Open the file for writing */
-	if (fd == -1)
-	{
-		perror("open");
-		free(tokens);
-		return -1;
-	}
-	pid_t pid = fork(); /* Fork a new process */
-	if (pid == -1)
-	{
-		perror("fork");
-		close(fd);
-		free(tokens);
-		return -1;
-	}
-	if (pid == 0)
-	{
-		if (dup2(fd, STDOUT_FILENO) == -1)
-		{ /* Redirect stdout to the file */
-			perror("dup2");
-			close(fd);
-			free(tokens);
-			exit(1);
-		}
-		close(fd);
-		if (execvp(args[0], args) == -1)
-		{
-			fprintf(stderr, "./hsh: %d: %s: not found\n", 1, args[0]);
-			free(tokens);
-			exit(1);
-		}
-		execvp(args[0], args);
-		perror("execvp");
-		free(tokens);
-		exit(1);
-	}
-	else
-	{
-		close(fd);
-		wait(NULL);
-	}
-	free(tokens);
-	return 1;
-}
-
-int DoubleRightDirect(char *line)
-{
-	int fd, i = 0, j = 0, position = 0;
-	char *filename;
-	char *args[100];
-	int bufsize = 64;
-	char **tokens = malloc(bufsize * sizeof(char *));
-	char *token;
-
-	if (!tokens)
-	{ /* Stanard Malloc Error Handling */
-		fprintf(stderr, "hsh: allocation error\n");
-		exit(EXIT_FAILURE);
-	}
-	token = strtok(line, " \t\r\n\a"); /* Tokenize the input */
-	while (token != NULL)
-	{
-		char *marker = _strstr(token, ">>"); /* Find the first occurrence of > and set it to variable marker */
-		if (marker)
-		{					/* If > is found in the input */
-			*marker = '\0'; /* Split the token at > */
-			if (*token != '\0')
-			{								/* If there is something before > */
-				tokens[position++] = token; /* Add the token before > */
-			}
-			tokens[position++] = ">>"; /* Add > to the tokens */
-			if (*(marker + 2) != '\0')
-			{									 /* If there is something after > */
-				tokens[position++] = marker + 2; /* Get rid of the space */
-			}
-		}
-		else
-		{
-			tokens[position++] = token; /* Add the token to the tokens */
-		}
-		if (position >= bufsize)
-		{														/* If the buffer is full */
-			bufsize += 64;										/* Increase the buffer size */
-			tokens = realloc(tokens, bufsize * sizeof(char *)); /* Reallocate the buffer */
-			if (!tokens)
-			{
-				fprintf(stderr, "hsh: allocation error\n");
-				exit(EXIT_FAILURE);
-			}
-		}
-		token = strtok(NULL, " \t\r\n\a"); /* Get the next token */
-	}
-	tokens[position] = NULL; /* Add NULL to the end of the tokens */
-	while (tokens[i] != NULL)
-	{
-		if (_strcmp(tokens[i], ">>") == 0)
-			break;			   /* If > is found in the tokens */
-		args[j++] = tokens[i]; /* Add the token to the args */
-		i++;
-	}
-	args[j] = NULL; /* Add NULL to the end of the args */
-	if (tokens[i] == NULL || tokens[i + 1] == NULL)
-	{ /* If there is no filename after > */
-		fprintf(stderr, "Syntax error: Missing filename after '>>'\n");
-		free(tokens);
-		return -1;
-	}
-
-	filename = tokens[i + 1];								  /* Get the filename */
-	fd = open(filename, O_WRONLY | O_CREAT | O_APPEND, 0644); /* Open the file for writing */
-	if (fd == -1)
-	{
-		perror("open");
-		free(tokens);
-		return -1;
-	}
-	pid_t pid = fork(); /* Fork a new process */
-	if (pid == -1)
-	{
-		perror("fork");
-		close(fd);
-		free(tokens);
-		return -1;
-	}
-	if (pid == 0)
-	{
-		if (dup2(fd, STDOUT_FILENO) == -1)
-		{ /* Redirect stdout to the file */
-			perror("dup2");
-			close(fd);
-			free(tokens);
-			exit(1);
-		}
-		close(fd);
-		if (execvp(args[0], args) == -1)
-		{
-			fprintf(stderr, "./hsh: %d: %s: not found\n", 1, args[0]);
-			for (int k = 0; k < position; k++)
-				free(tokens[k]);
-			free(tokens);
-			exit(127);
-		}
-		perror("execvp");
-		free(tokens);
-		exit(1);
-	}
-	else
-	{
-		close(fd);
-		wait(NULL);
-	}
-	free(tokens);
-	return 1;
-}
-
-int LeftDirect(char *line)
-{
-	int fd, i = 0, j = 0, position = 0;
-	char *filename;
-	char *args[100];
-	int bufsize = 64;
-	char **tokens = malloc(bufsize * sizeof(char *));
-	char *token;
-
-	if (!tokens)
-	{
-		fprintf(stderr, "hsh: allocation error\n");
-		exit(EXIT_FAILURE);
-	}
-
-	token = strtok(line, " \t\r\n\a");
-	while (token != NULL)
-	{
-		char *marker = _strchr(token, '<');
-		if (marker)
-		{
-			*marker = '\0';
-			if (*token != '\0')
-			{
-				tokens[position++] = token;
-			}
-			tokens[position++] = "<";
-			if (*(marker + 1) != '\0')
-			{
-				tokens[position++] = marker + 1;
-			}
-		}
-		else
-		{
-			tokens[position++] = token;
-		}
-
-		if (position >= bufsize)
-		{
-			bufsize += 64;
-			tokens = realloc(tokens, bufsize * sizeof(char *));
-			if (!tokens)
-			{
-				fprintf(stderr, "hsh: allocation error\n");
-				exit(EXIT_FAILURE);
-			}
-		}
-		token = strtok(NULL, " \t\r\n\a");
-	}
-	tokens[position] = NULL;
-
-	while (tokens[i] != NULL)
-	{
-		if (_strcmp(tokens[i], "<") == 0)
-			break;
-		args[j++] = tokens[i];
-		i++;
-	}
-	args[j] = NULL;
-
-	if (tokens[i] == NULL || tokens[i + 1] == NULL)
-	{
-		fprintf(stderr, "Syntax error: Missing filename after '<'\n");
-		free(tokens);
-		return -1;
-	}
-
-	filename = tokens[i + 1];
-	fd = open(filename, O_RDONLY);
-	if (fd == -1)
-	{
-		perror("open");
-		free(tokens);
-		return -1;
-	}
-
-	pid_t pid = fork();
-	if (pid == -1)
-	{
-		perror("fork");
-		close(fd);
-		free(tokens);
-		return -1;
-	}
-
-	if (pid == 0)
-	{
-		if (dup2(fd, STDIN_FILENO) == -1)
-		{
-			perror("dup2");
-			close(fd);
-			free(tokens);
-			exit(1);
-		}
-		close(fd);
-
-		if (execvp(args[0], args) == -1)
-		{
-			fprintf(stderr, "./hsh: %d: %s: not found\n", 1, args[0]);
-			free(tokens);
-			exit(1);
-		}
-		execvp(args[0], args);
-		perror("execvp");
-		free(tokens);
-		exit(1);
-	}
-	else
-	{
-		close(fd);
-		wait(NULL);
-	}
-
-	free(tokens);
-	return 1;
-}
-
-int DoubleLeftDirect(char *line)
-{
-	int fd, i = 0, j = 0, position = 0;
-	char *delimiter;
-	char *args[100];
-	int bufsize = 64;
-	char **tokens = malloc(bufsize * sizeof(char *));
-	char *token;
-
-	if (!tokens)
-	{
-		fprintf(stderr, "hsh: allocation error\n");
-		exit(EXIT_FAILURE);
-	}
-
-	token = strtok(line, " \t\r\n\a");
-	while (token != NULL)
-	{
-		char *marker = _strchr(token, '<');
-		if (marker && *(marker + 1) == '<')
-		{
-			*marker = '\0';
-			if (*token != '\0')
-			{
-				tokens[position++] = token;
-			}
-			tokens[position++] = "<<";
-			if (*(marker + 2) != '\0')
-			{
-				tokens[position++] = marker + 2;
-			}
-		}
-		else
-		{
-			tokens[position++] = token;
-		}
-
-		if (position >= bufsize)
-		{
-			bufsize += 64;
-			tokens = realloc(tokens, bufsize * sizeof(char *));
-			if (!tokens)
-			{
-				fprintf(stderr, "hsh: allocation error\n");
-				exit(EXIT_FAILURE);
-			}
-		}
-		token = strtok(NULL, " \t\r\n\a");
-	}
-	tokens[position] = NULL;
-
-	while (tokens[i] != NULL)
-	{
-		if (_strcmp(tokens[i], "<<") == 0)
-			break;
-		args[j++] = tokens[i];
-		i++;
-	}
-	args[j] = NULL;
-
-	if (tokens[i] == NULL || tokens[i + 1] == NULL)
-	{
-		fprintf(stderr, "Syntax error: Missing delimiter after '<<'\n");
-		free(tokens);
-		return -1;
-	}
-
-	delimiter = tokens[i + 1];
-
-	char input[1024];
-	char *input_buffer = input;
-	printf("Enter input (end with %s):\n", delimiter);
-
-	while (fgets(input_buffer, sizeof(input), stdin))
-	{
-		if (strncmp(input_buffer, delimiter, strlen(delimiter)) == 0)
-		{
-			break;
-		}
-		input_buffer += strlen(input_buffer);
-	}
-
-	pid_t pid = fork();
-	if (pid == -1)
-	{
-		perror("fork");
-		free(tokens);
-		return -1;
-	}
-
-	if (pid == 0)
-	{
-		fd = open("/tmp/heredoc.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
-		if (fd == -1)
-		{
-			perror("open");
-			free(tokens);
-			exit(1);
-		}
-		write(fd, input, strlen(input));
-		close(fd);
-
-		fd = open("/tmp/heredoc.txt", O_RDONLY);
-		if (fd == -1)
-		{
-			perror("open");
-			free(tokens);
-			exit(1);
-		}
-
-		if (dup2(fd, STDIN_FILENO) == -1)
-		{
-			perror("dup2");
-			close(fd);
-			free(tokens);
-			exit(1);
-		}
-		close(fd);
-
-		if (execvp(args[0], args) == -1)
-		{
-			fprintf(stderr, "./hsh: %d: %s: not found\n", 1, args[0]);
-			free(tokens);
-			exit(1);
-		}
-		execvp(args[0], args);
-		perror("execvp");
-		free(tokens);
-		exit(1);
-	}
-	else
-	{
-		wait(NULL);
-	}
-
-	free(tokens);
-	return 1;
-}
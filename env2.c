@@ -1,117 +1,52 @@
 #include "main.h"
 
 /**
- * buildListPath - builds a singly linked list off the environ variable PATH
+ * findPath - finds the path of a command about to be run
+ * @name: name of command
  *
- * Return: singly linked list of PATH variables, NULL if failed
+ * Return: malloc'd path if found, NULL if not found
  */
-path_t *buildListPath(void)
+char *findPath(char *name)
 {
-	path_t *new_node = NULL;
-	path_t *head = NULL;
-	char *path = _getenv("PATH");
-	char *temp_path = NULL;
-	char *token = NULL;
+	path_table_t *table;
+	char candidate[PATH_MAX], *cached = NULL;
+	size_t i, name_len;
+	unsigned long dir_epoch;
 
-	if (path == NULL)
-		return (NULL);
-	temp_path = _strdup(path);
-	token = strtok(temp_path, ":");
-
-	free(path); /* Free the duplicated path from _getenv */
-	while (token != NULL)
+	if (_strchr(name, '/')) /* path already, never hashed */
 	{
-		new_node = (path_t *)malloc(sizeof(path_t));
-		if (new_node == NULL)
-		{
-			free(temp_path);
-			destroyListPath(head); /* Clean up on failure */
+		if (access(name, F_OK) != 0)
 			return (NULL);
-		}
-		new_node->directory = _strdup(token);
-		if (new_node->directory == NULL)
-		{
-			free(temp_path);
-			free(new_node);
-			destroyListPath(head);
-			return (NULL);
-		}
-		new_node->next = head;
-		head = new_node;
-		token = strtok(NULL, ":");
+		return (_strdup(name));
 	}
-	free(temp_path);
-	return (head);
-}
 
-/**
- * findPath - finds the path of a given command
- * @name: name of command
- *
- * Return: path if found, name if not found
- */
-char *findPath(char *name)
-{
-	path_t *temp = NULL;
-	path_t *head = NULL;
-	char *temp_path = NULL, *mallocd_name = NULL;
+	cached = hashHit(name); /* remembered from an earlier lookup */
+	if (cached != NULL)
+		return (_strdup(cached));
 
-	if (_strchr(name, '/') && !access(name, F_OK)) /* checks if path already */
-	{
-		mallocd_name = _strdup(name);
-		return (mallocd_name);
-	}
+	table = getPathTable(); /* parsed once per PATH change */
+	dir_epoch = pathDirsEpoch(); /* taken before searching, never after */
+	if (missLookup(name, table->generation, dir_epoch))
+		return (NULL); /* nothing was installed since the last miss */
 
-	head = buildListPath(); /* populates list and points at head */
-	if (head == NULL)
+	name_len = _strlen(name);
+	for (i = 0; i < table->count; i++) /* PATH order, first match wins */
 	{
-		return (NULL); /*Return copy of name*/
-	}
-	temp = head; /* iterator initialization */
-
-	while (temp != NULL) /* run until list is empty */
-	{					 /* malloc space for path/name\0 */
-		temp_path = malloc(_strlen(temp->directory) + _strlen(name) + 2);
-		if (temp_path == NULL)
-		{
-			destroyListPath(head);
-			return (NULL);
-		}
-		_strcpy(temp_path, temp->directory);
-		_strcat(temp_path, "/");
-		_strcat(temp_path, name);
-		if (access(temp_path, F_OK) == 0) /* checks if cmd at path exists */
+		if (!pathDirHasCommand(&table->dirs[i], name))
+			continue;
+		if (buildCandidate(&table->dirs[i], name, name_len, candidate) != NULL)
 		{
-			destroyListPath(head); /* frees list of paths */
-			return (temp_path);	   /* returns found path + name */
+			hashInsert(name, candidate); /* next lookup costs no syscalls */
+			return (_strdup(candidate));
 		}
-		free(temp_path);   /* frees temp_path */
-		temp = temp->next; /* go to next location */
 	}
-	destroyListPath(head);
-	return (NULL);		   /* returns malloced command name without a path */
+	missInsert(name, table->generation, dir_epoch);
+	return (NULL);
 }
 
-/**
- * destroyListPath - frees the ListPath
- * @h: head of listpath
- */
-void destroyListPath(path_t *h)
-{
-	path_t *temp = NULL;
-
-	while (h != NULL)
-	{
-		temp = h;
-		h = h->next;
-		free(temp->directory);
-		free(temp);
-	}
-}
 char *getHostname(void)
 {
 	char *hostname = _getenv("NAME");
-	char *temp;
 
 	if (!hostname)
 		hostname = _getenv("HOSTNAME");
@@ -123,9 +58,7 @@ char *getHostname(void)
 	}
 	else
 	{
-		temp = _strdup(hostname);
-		free(hostname);
-		return (temp);
+		return (_strdup(hostname)); /* the env store owns the original */
 	}
 }
 
@@ -137,7 +70,6 @@ char *getHostname(void)
 char *getUser(void)
 {
 	char *user = _getenv("USER");
-	char *temp;
 
 	if (!user)
 		user = _getenv("LOGNAME");
@@ -146,9 +78,7 @@ char *getUser(void)
 		return (_strdup("unknown")); /* direct return */
 	}
 	else
-	{ /* always duplicate */
-		temp = _strdup(user);
-		free(user);
-		return (temp);
+	{ /* always duplicate, the env store owns the original */
+		return (_strdup(user));
 	}
 }
@@ -0,0 +1,350 @@
+#include "main.h"
+
+#define ENV_TABLE_MIN 64
+
+static env_slot_t *env_table;
+static size_t env_table_cap;
+static char **env_lines;	   /* the variables, "NAME=value", owned here */
+static int env_count;
+static int env_cap;			   /* slots in env_lines, doubles when full */
+static char *env_slab;		   /* inherited lines, one allocation */
+static size_t env_slab_size;
+static char **env_envp;		   /* execve() view, see envGetEnvp() */
+static int env_envp_cap;
+static int env_envp_count;	   /* leading env_lines it mirrors */
+
+/**
+ * envHash - FNV-1a hash of a variable name
+ * @name: variable name, not necessarily NUL terminated
+ * @len: length of name
+ *
+ * Return: hash of name
+ */
+static unsigned int envHash(const char *name, size_t len)
+{
+	unsigned int hash = 2166136261u;
+	size_t i;
+
+	for (i = 0; i < len; i++)
+	{
+		hash ^= (unsigned char)name[i];
+		hash *= 16777619u;
+	}
+	return (hash);
+}
+
+/**
+ * envNameLen - length of the name part of a "NAME=value" line
+ * @line: environment line
+ *
+ * Return: number of bytes before the first '='
+ */
+static size_t envNameLen(const char *line)
+{
+	size_t len = 0;
+
+	while (line[len] != '\0' && line[len] != '=')
+		len++;
+	return (len);
+}
+
+/**
+ * envTablePlace - records that the variable on env_lines[index] exists
+ * @index: index into env_lines
+ *
+ * Description: the first occurrence of a name wins, like getenv(3).
+ * The table must have a free slot.
+ */
+static void envTablePlace(int index)
+{
+	size_t len = envNameLen(env_lines[index]);
+	unsigned int hash = envHash(env_lines[index], len);
+	size_t mask = env_table_cap - 1, i;
+	const char *line;
+
+	for (i = hash & mask; env_table[i].index != -1; i = (i + 1) & mask)
+	{
+		line = env_lines[env_table[i].index];
+		if (env_table[i].hash == hash &&
+			_strncmp(line, env_lines[index], len) == 0 && line[len] == '=')
+			return; /* duplicate name */
+	}
+	env_table[i].hash = hash;
+	env_table[i].index = index;
+}
+
+/**
+ * envGrow - makes sure a pointer vector has room for need elements
+ * @vec: vector to grow
+ * @cap: its capacity, updated
+ * @need: number of elements required
+ *
+ * Description: capacity doubles, so appending n variables moves O(n)
+ * pointers in total; the strings themselves are never copied.
+ *
+ * Return: 0 on success, -1 on malloc failure (vec left untouched)
+ */
+static int envGrow(char ***vec, int *cap, int need)
+{
+	int new_cap = *cap > 0 ? *cap : ENV_TABLE_MIN;
+	char **new_vec;
+
+	if (need <= *cap)
+		return (0);
+	while (new_cap < need)
+		new_cap *= 2;
+	new_vec = realloc(*vec, sizeof(char *) * new_cap);
+	if (new_vec == NULL)
+		return (-1);
+	*vec = new_vec;
+	*cap = new_cap;
+	return (0);
+}
+
+/**
+ * envTableBuild - (re)indexes every variable
+ *
+ * Description: sized so the load factor stays at or below one half;
+ * called after import, on growth and whenever a removal shifts indices.
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+int envTableBuild(void)
+{
+	size_t cap = ENV_TABLE_MIN, i;
+	env_slot_t *table;
+
+	while (cap < (size_t)env_count * 2 + 2)
+		cap *= 2;
+
+	table = malloc(sizeof(env_slot_t) * cap);
+	if (table == NULL)
+		return (-1);
+	free(env_table);
+	env_table = table;
+	env_table_cap = cap;
+	for (i = 0; i < cap; i++)
+		env_table[i].index = -1;
+	for (i = 0; i < (size_t)env_count; i++)
+		envTablePlace(i);
+	return (0);
+}
+
+/**
+ * envFreeLine - frees a line unless it lives in the import slab
+ * @line: "NAME=value" line of the store
+ */
+static void envFreeLine(char *line)
+{
+	if (line < env_slab || line >= env_slab + env_slab_size)
+		free(line);
+}
+
+/**
+ * envTableImport - makes the store the owner of a copy of src
+ * @src: NULL terminated array of "NAME=value" strings, e.g. environ
+ *
+ * Description: all inherited lines are copied back to back into a single
+ * slab and env_lines points into it. Only lines set later are allocated
+ * one by one; envFreeLine() tells the two apart.
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+int envTableImport(char **src)
+{
+	int i, size = 0;
+	size_t len, offset = 0;
+
+	while (src && src[size] != NULL)
+		offset += _strlen(src[size++]) + 1;
+	env_slab_size = offset;
+	env_slab = malloc(env_slab_size ? env_slab_size : 1);
+	env_cap = ENV_TABLE_MIN;
+	while (env_cap < size + 1)
+		env_cap *= 2;
+	env_lines = malloc(sizeof(char *) * env_cap);
+	if (env_slab == NULL || env_lines == NULL)
+	{
+		envTableDestroy();
+		return (-1);
+	}
+	for (i = 0, offset = 0; i < size; i++)
+	{
+		len = _strlen(src[i]) + 1;
+		memcpy(env_slab + offset, src[i], len);
+		env_lines[i] = env_slab + offset;
+		offset += len;
+	}
+	env_lines[size] = NULL;
+	env_count = size;
+	env_envp_count = 0; /* none of the old lines are in the view */
+	if (env_envp != NULL)
+		env_envp[0] = NULL;
+	return (envTableBuild());
+}
+
+/**
+ * envTableFind - looks a variable up without allocating
+ * @name: variable name
+ * @len: length of name
+ *
+ * Return: index of the variable, -1 if not set
+ */
+int envTableFind(const char *name, size_t len)
+{
+	unsigned int hash = envHash(name, len);
+	size_t mask, i;
+	const char *line;
+
+	if (env_table == NULL)
+		return (-1);
+
+	mask = env_table_cap - 1;
+	for (i = hash & mask; env_table[i].index != -1; i = (i + 1) & mask)
+	{
+		line = env_lines[env_table[i].index];
+		if (env_table[i].hash == hash && _strncmp(line, name, len) == 0 &&
+			line[len] == '=')
+			return (env_table[i].index);
+	}
+	return (-1);
+}
+
+/**
+ * envTableGet - returns the "NAME=value" line of a variable
+ * @index: index from envTableFind()
+ *
+ * Return: line, owned by the store
+ */
+char *envTableGet(int index)
+{
+	return (env_lines[index]);
+}
+
+/**
+ * envTableReplace - replaces the line of an existing variable
+ * @index: index from envTableFind()
+ * @line: malloc'd "NAME=value" line for the same name, now owned here
+ *
+ * Description: environ may point at the envp view, so the view is
+ * updated before the old line is freed; it never holds a freed line.
+ */
+void envTableReplace(int index, char *line)
+{
+	if (index < env_envp_count)
+		env_envp[index] = line;
+	envFreeLine(env_lines[index]);
+	env_lines[index] = line;
+}
+
+/**
+ * envTableAppend - adds a variable that is not set yet
+ * @line: malloc'd "NAME=value" line, owned by the store on success
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+int envTableAppend(char *line)
+{
+	if (envGrow(&env_lines, &env_cap, env_count + 2) == -1)
+		return (-1);
+	env_lines[env_count] = line;
+	env_lines[env_count + 1] = NULL;
+	env_count++;
+	if (env_envp != NULL && env_envp_count == env_count - 1 &&
+		env_envp_cap > env_count) /* room in the view, no need to wait */
+	{
+		env_envp[env_envp_count++] = line;
+		env_envp[env_envp_count] = NULL;
+	}
+	if ((size_t)env_count * 2 + 2 > env_table_cap) /* keep load <= 1/2 */
+		return (envTableBuild());
+	envTablePlace(env_count - 1);
+	return (0);
+}
+
+/**
+ * envTableRemove - removes a variable, keeping the others in order
+ * @index: index from envTableFind()
+ *
+ * Description: like envTableReplace(), drops the line from the envp
+ * view before freeing it.
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+int envTableRemove(int index)
+{
+	if (index < env_envp_count)
+	{
+		memmove(&env_envp[index], &env_envp[index + 1],
+				sizeof(char *) * (env_envp_count - index)); /* and NULL */
+		env_envp_count--;
+	}
+	envFreeLine(env_lines[index]);
+	memmove(&env_lines[index], &env_lines[index + 1],
+			sizeof(char *) * (env_count - index)); /* includes the NULL */
+	env_count--;
+	return (envTableBuild()); /* indices after index shifted */
+}
+
+/**
+ * envTableCount - number of variables in the store
+ *
+ * Return: count
+ */
+int envTableCount(void)
+{
+	return (env_count);
+}
+
+/**
+ * envGetEnvp - returns the environment in the form execve() wants
+ *
+ * Description: replacements, removals and appends that fit update the
+ * array in place, so only variables appended while it was full are
+ * copied in here; running many commands builds it once. environ is
+ * pointed at it as well, so getenv() and library calls such as execvp()
+ * see the same variables, and never a line the store has freed.
+ *
+ * Return: NULL terminated array, owned by the store, NULL on malloc failure
+ */
+char **envGetEnvp(void)
+{
+	if (env_envp != NULL && env_envp_count == env_count)
+		return (env_envp);
+
+	if (envGrow(&env_envp, &env_envp_cap, env_count + 1) == -1)
+		return (NULL);
+	environ = env_envp; /* realloc may have moved it */
+	memcpy(env_envp + env_envp_count, env_lines + env_envp_count,
+		   sizeof(char *) * (env_count - env_envp_count));
+	env_envp[env_count] = NULL;
+	env_envp_count = env_count;
+	return (env_envp);
+}
+
+/**
+ * envTableDestroy - frees the store and its index
+ */
+void envTableDestroy(void)
+{
+	int i;
+
+	for (i = 0; i < env_count; i++)
+		envFreeLine(env_lines[i]);
+	free(env_slab);
+	env_slab = NULL;
+	env_slab_size = 0;
+	free(env_lines);
+	env_lines = NULL;
+	env_count = 0;
+	env_cap = 0;
+	free(env_table);
+	env_table = NULL;
+	env_table_cap = 0;
+	if (environ == env_envp)
+		environ = NULL;
+	free(env_envp);
+	env_envp = NULL;
+	env_envp_cap = 0;
+	env_envp_count = 0;
+}
@@ -1,191 +1,196 @@
 #include "main.h"
-#define FORK_ERROR -1
-#define WAITPID_ERROR -2
 
 /**
- * execute_pipe_command - Executes two commands, connecting their
- *                        standard input and output with a pipe.
- * @command1: The first command (left side of pipe).  This is an array
- *             of strings, where command1[0] is the command name,
- *             and subsequent elements are the arguments.  This array
- *             MUST be NULL-terminated.
- * @command2: The second command (right side of pipe).  Same format as
- *             command1.
+ * execute_list - runs a parsed command line, the one executor every line
+ *                goes through
+ * @list: list of pipelines from parseLine()
+ * @isAtty: 1 if interactive, 0 otherwise
  *
- * Return: 0 on success, the exit status of the *second* command if
- *         either command fails, or -1 on system call errors (pipe, fork).
- *         Returns 127 if either command is not found.
+ * Description: a pipeline after && only runs if the last status is 0, one
+ * after || only if it is not; skipped pipelines leave the status as is.
+ *
+ * Return: The exit status of the last pipeline that ran.
  */
-void execute_pipe_command(char **commands, int num_commands)
+int execute_list(pipeline_t *list, int isAtty)
 {
-	if (num_commands <= 0)
-	{
-		return; /* Nothing to do */
-	}
+	int status = 0;
 
-	if (num_commands == 1)
+	for (; list != NULL; list = list->next)
 	{
-		/* If there's only one command, we don't need pipes where we're going. */
-		char **args = parse_command(commands[0]);
-		if (args != NULL)
-		{
-			if (args[0] != NULL)
-			{ /* check for empty command */
-				char *full_path = findPath(args[0]);
-				if (full_path != NULL)
-				{
-					execute_command(full_path, args);
-					free(full_path);
-				}
-				else
-				{ /* command not found */
-					fprintf(stderr, "%s: command not found\n", args[0]);
-				}
-			}
-			free(args);
-		}
-		return;
+		if ((list->connector == TOK_AND_IF && status != 0) ||
+			(list->connector == TOK_OR_IF && status == 0))
+			continue;
+		if (list->ncmds == 1)
+			status = executeIfValid(isAtty, list->cmds,
+									list->next == NULL);
+		else
+			status = execute_pipe_command(list, isAtty);
 	}
+	return (status);
+}
 
-	/* --- Multiple commands, create pipes --- */
-
-	int pipes[num_commands - 1][2]; /* Array of pipes */
-	pid_t pids[num_commands];		/* Array to store child PIDs */
-
-	/* Create all necessary pipes */
-	for (int i = 0; i < num_commands - 1; i++)
+/**
+ * runBuiltin - runs a builtin in the shell process, with its stdin,
+ * stdout and redirections applied for as long as it runs
+ * @job: the command; fd_in and fd_out are -1 to keep the shell's
+ * @isAtty: 1 if interactive, 0 otherwise
+ *
+ * Return: the builtin's exit status, 2 if a redirection failed
+ */
+int runBuiltin(launch_t *job, int isAtty)
+{
+	redir_save_t *saved = NULL;
+	int status = 2, failed;
+	redir_t *r;
+
+	fflush(stdout); /* what was printed so far goes where it was meant to */
+	if ((job->fd_in != -1 && (redirSave(STDIN_FILENO, &saved) == -1 ||
+							  dup2(job->fd_in, STDIN_FILENO) == -1)) ||
+		(job->fd_out != -1 && (redirSave(STDOUT_FILENO, &saved) == -1 ||
+							   dup2(job->fd_out, STDOUT_FILENO) == -1)))
+		perror("dup2");
+	else if (redirApply(job->redirs, &saved, &failed) == -1)
 	{
-		if (pipe(pipes[i]) < 0)
-		{
-			perror("pipe");
-			return; /* Handle pipe creation failure */
-		}
+		for (r = job->redirs; failed > 0; failed--)
+			r = r->next;
+		redirError(r, errno);
 	}
+	else
+		status = builtinStatus(customCmd(job->argv, isAtty), job->argv);
+	fflush(stdout);
+	redirRestore(saved);
+	return (status);
+}
 
-	/* Fork and execute each command */
-	for (int i = 0; i < num_commands; i++)
+/**
+ * execute_pipe_command - Executes a pipeline, connecting the standard
+ *                        output of each stage to the input of the next.
+ * @pipeline: parsed pipeline, at least two commands
+ * @isAtty: 1 if interactive, 0 otherwise
+ *
+ * Description: pipes are made one stage at a time and close-on-exec, so
+ * only the ends a stage uses reach it and at most one pipe is open in the
+ * shell. Each stage's own redirections are applied after the pipe ends,
+ * so "ls | wc > f" writes wc's output to f. A stage that cannot start is
+ * reported by the shell and the rest of the pipeline still runs.
+ * Builtins are never exec'd: a builtin stage runs in a forked child, or
+ * in the shell itself when it is the last stage, like ksh and zsh, so
+ * "ls | cd /tmp" does change directory.
+ *
+ * Return: the exit status of the last stage, 2 if a pipe failed
+ */
+int execute_pipe_command(pipeline_t *pipeline, int isAtty)
+{
+	launch_t job = {0};
+	pid_t pids[pipeline->ncmds]; /* -1 for stages that did not start */
+	int ends[2], fd_in = -1, status = 0, i, n = 0;
+	cmd_t *cmd;
+	char *full_path;
+
+	inputSync(); /* the first stage may read the rest of stdin */
+	for (cmd = pipeline->cmds; cmd != NULL; cmd = cmd->next, n++)
 	{
-		pids[i] = fork();
-		if (pids[i] < 0)
+		ends[0] = ends[1] = -1;
+		if (cmd->next != NULL && pipe2(ends, O_CLOEXEC) == -1)
 		{
-			perror("fork");
-			return; /* Handle fork failure */
+			perror("pipe");
+			status = 2;
+			break;
 		}
-		else if (pids[i] == 0)
+		pids[n] = -1;
+		job.argv = cmd->argv;
+		job.redirs = cmd->redirs;
+		job.fd_in = fd_in;
+		job.fd_out = ends[1];
+		if (cmd->argv[0] == NULL) /* only redirections */
+			status = redirTouch(cmd->redirs);
+		else if (builtinFind(cmd->argv[0]) != NULL)
 		{
-			/* Child process */
-
-			/* Redirect input (except for the first command) */
-			if (i > 0)
-			{
-				if (dup2(pipes[i - 1][0], STDIN_FILENO) < 0)
-				{
-					perror("dup2 (stdin)");
-					exit(EXIT_FAILURE);
-				}
-			}
-
-			/* Redirect output (except for the last command) */
-			if (i < num_commands - 1)
-			{
-				if (dup2(pipes[i][1], STDOUT_FILENO) < 0)
-				{
-					perror("dup2 (stdout)");
-					exit(EXIT_FAILURE);
-				}
-			}
-
-			/* Close all pipe ends in the child */
-			for (int j = 0; j < num_commands - 1; j++)
-			{
-				close(pipes[j][0]);
-				close(pipes[j][1]);
-			}
-
-			/* Parse the command */
-			char **args = parse_command(commands[i]);
-			if (args == NULL || args[0] == NULL)
-			{
-				fprintf(stderr, "Invalid command\n"); /* error message */
-				exit(EXIT_FAILURE);
-			}
-			char *full_path = findPath(args[0]); /* find full path */
-			if (full_path == NULL)
+			if (cmd->next == NULL) /* lastpipe: in the shell, no fork */
+				status = runBuiltin(&job, isAtty);
+			else
 			{
-				fprintf(stderr, "%s: command not found\n", args[0]);
-				exit(127); 
+				pids[n] = launchBuiltin(&job, ends[0]);
+				status = job.status;
 			}
-			/* Execute the command */
-			execve(full_path, args, environ);
-			perror("execve"); /* If execve returns, it failed */
-			exit(EXIT_FAILURE);
 		}
+		else if ((full_path = findPath(cmd->argv[0])) == NULL)
+		{
+			fprintf(stderr, "%s: 1: %s: not found\n", shellName(),
+					cmd->argv[0]);
+			status = 127;
+		}
+		else
+		{
+			job.path = full_path;
+			pids[n] = launchSpawn(&job);
+			status = job.status;
+			free(full_path);
+		}
+		if (fd_in != -1)
+			close(fd_in);
+		if (ends[1] != -1)
+			close(ends[1]);
+		fd_in = ends[0];
 	}
+	if (fd_in != -1) /* a pipe failed after this one was made */
+		close(fd_in);
 
-	/* Parent process: Close all pipe ends */
-	for (int i = 0; i < num_commands - 1; i++)
-	{
-		close(pipes[i][0]);
-		close(pipes[i][1]);
-	}
-
-	/* Wait for all child processes to finish */
-	for (int i = 0; i < num_commands; i++)
-	{
-		waitpid(pids[i], NULL, 0);
-	}
+	for (i = 0; i < n; i++)
+		if (pids[i] != -1)
+		{
+			if (i == pipeline->ncmds - 1)
+				status = launchWait(pids[i]);
+			else
+				launchWait(pids[i]);
+		}
+	return (status);
 }
 
 /**
- * execute_command - Executes a single command.
- * @args: The arguments of the command.
- * @path_list: Linked list of PATH directories.
+ * execute_command - Executes a single command and waits for it.
+ * @commandPath: full path returned by findPath()
+ * @arguments: The arguments of the command.
+ * @redirs: redirections applied in the child, NULL if none
  *
- * Return: 0 on success, appropriate error code on failure.
+ * Return: the command's exit status, 128 + the signal number if it was
+ * killed; 126, 127 or 2 after the launch layer reported why it could
+ * not start
  */
-int execute_command(const char *commandPath, char **arguments)
+int execute_command(const char *commandPath, char **arguments,
+					redir_t *redirs)
 {
+	launch_t job = {0};
 	pid_t pid;
-	int status;
 
-	// int isCommandRtn = isCommand(commandPath);
-	// printf("\nisCommand: %d\n\n", isCommandRtn);
-	// // if (isCommandRtn)
-	// // 	printf("\nisCommand: %d\n\n", isCommandRtn);
+	job.path = commandPath;
+	job.argv = arguments;
+	job.redirs = redirs;
+	job.fd_in = job.fd_out = -1;
 
-	pid = fork();
+	inputSync(); /* give read-ahead back, the child may read stdin */
+	pid = launchSpawn(&job);
 	if (pid == -1)
-	{
-		perror("fork");
-		return FORK_ERROR;
-	}
-	else if (pid == 0)
-	{
-		/* Child process */
-		execve(commandPath, arguments, environ);
-		/* perror("execve"); *//* execve failed */
-		exit(EXIT_FAILURE); /* Exit the child! */
-	}
-	else
-	{
-		/* Parent process */
-		if (waitpid(pid, &status, 0) == -1)
-		{
-			perror("waitpid");
-			return WAITPID_ERROR;
-		}
+		return (job.status);
+	return (launchWait(pid));
+}
 
-		if (WIFEXITED(status))
-		{
-			return WEXITSTATUS(status);
-		}
-		else if (WIFSIGNALED(status))
-		{
-			fprintf(stderr, "Command terminated by signal %d\n", WTERMSIG(status));
-			return -1; /* Or a specific signal error code */
-		}
-	}
-	return 0; /* Success */
+/**
+ * execute_tail - runs the shell's final command in place of the shell
+ * @commandPath: full path returned by findPath()
+ * @arguments: argv for the command
+ *
+ * Description: nothing would run after the command and the shell has no
+ * traps, so waiting for a child only to exit with its status is wasted;
+ * exec directly instead, like dash does.
+ * On failure the caller runs the command normally, which reports the error.
+ */
+void execute_tail(const char *commandPath, char **arguments)
+{
+	fflush(stdout); /* the exec drops anything still buffered */
+	fflush(stderr);
+	inputSync();
+	pathExec(commandPath, arguments, envGetEnvp());
 }
 
 /**
@@ -196,41 +201,26 @@ int execute_command(const char *commandPath, char **arguments)
  */
 int isCommand(const char *fp)
 {
-	path_t *temp = NULL;
-	path_t *head = NULL;
-	char *temp_path = NULL;
+	path_table_t *table;
+	size_t i;
 
 	if (_strchr(fp, '/') && !access(fp, F_OK)) /* checks if path already */
 		return (1);
         // return (access(fp, F_OK | X_OK) == 0 ? 1 : 0);
 
-	head = buildListPath(); /* populates list and points at head */
-	if (!head)
+	if (hashLookup(fp) != NULL)
+		return (1);
+
+	table = getPathTable();
+	if (table->count == 0)
 	{
-		return (-2); /*Return copy of fp*/
+		return (-2); /* no PATH to search */
 	}
-	temp = head; /* iterator initialization */
 
-	while (temp != NULL) /* run until list is empty */
-	{					 /* malloc space for path/fp\0 */
-		temp_path = malloc(_strlen(temp->directory) + _strlen(fp) + 2);
-		if (temp_path == NULL)
-		{
-			destroyListPath(head);
-			return (-1);
-		}
-		_strcpy(temp_path, temp->directory);
-		_strcat(temp_path, "/");
-		_strcat(temp_path, fp);
-		if (access(temp_path, F_OK) == 0) /* checks if cmd at path exists */
-		{
-			destroyListPath(head); /* frees list of paths */
-			free(temp_path);
-			return (1);	   /* returns found path + fp */
-		}
-		free(temp_path);   /* frees temp_path */
-		temp = temp->next; /* go to next location */
+	for (i = 0; i < table->count; i++)
+	{
+		if (pathDirHasCommand(&table->dirs[i], fp)) /* relative to dir fd */
+			return (1);
 	}
-	destroyListPath(head);
 	return (0);		   /* not a valid filepath. consider returning errno? */
 }
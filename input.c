@@ -0,0 +1,343 @@
+#include "main.h"
+#include <sys/mman.h>
+
+#define INPUT_BLOCK 65536
+
+static input_t in = {INPUT_STDIN, NULL, 0, 0, NULL, 0, NULL, 0, 0, 0, -1, NULL,
+					 0, NULL, STDIN_FILENO};
+
+/**
+ * inputOpenScript - makes the shell read its commands from a file
+ * @path: script path from the command line
+ *
+ * Description: a regular file is opened read-only and mapped MAP_PRIVATE,
+ * so lines can be NUL terminated in place; the few pages written to are
+ * copied by the kernel and the file itself is never modified. Anything
+ * else, e.g. /dev/stdin on a pipe or "<(...)", has no size to map and is
+ * read in blocks like stdin, through its own descriptor.
+ *
+ * Return: 0 on success, -1 with errno set if the file cannot be read
+ */
+int inputOpenScript(const char *path)
+{
+	struct stat script_stat;
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	void *map;
+
+	if (fd == -1)
+		return (-1);
+	if (fstat(fd, &script_stat) == -1)
+	{
+		close(fd);
+		return (-1);
+	}
+	if (!S_ISREG(script_stat.st_mode))
+	{
+		in.fd = fdReserve(fd); /* out of the way of the redirections */
+		return (in.fd == -1 ? -1 : 0);
+	}
+	in.mode = INPUT_SCRIPT;
+	in.pos = 0;
+	in.size = script_stat.st_size;
+	if (in.size == 0) /* nothing to map, immediately at end of input */
+	{
+		close(fd);
+		return (0);
+	}
+	map = mmap(NULL, in.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd); /* the mapping keeps the file referenced */
+	if (map == MAP_FAILED)
+		return (-1);
+	madvise(map, in.size, MADV_SEQUENTIAL);
+	in.map = map;
+	return (0);
+}
+
+/**
+ * inputOpenString - makes the shell run the command string given with -c
+ * @command: the string, from argv; split into lines in place like a script
+ */
+void inputOpenString(char *command)
+{
+	in.mode = INPUT_STRING;
+	in.map = command;
+	in.size = _strlen(command);
+	in.pos = 0;
+}
+
+/**
+ * inputScriptLine - returns the next line of the mapped script or -c string
+ *
+ * Return: the line, NUL terminated inside the mapping, NULL at the end
+ */
+static char *inputScriptLine(void)
+{
+	char *line, *newline;
+	size_t len;
+
+	if (in.pos >= in.size)
+		return (NULL);
+	line = in.map + in.pos;
+	newline = memchr(line, '\n', in.size - in.pos);
+	if (newline != NULL)
+	{
+		*newline = '\0';
+		in.pos = newline - in.map + 1;
+		return (line);
+	}
+
+	/* last line has no newline and may end flush with the mapping */
+	len = in.size - in.pos;
+	in.pos = in.size;
+	if (len + 1 > in.line_cap)
+	{
+		free(in.line_buf);
+		in.line_buf = malloc(len + 1);
+		if (in.line_buf == NULL)
+		{
+			in.line_cap = 0;
+			return (NULL);
+		}
+		in.line_cap = len + 1;
+	}
+	memcpy(in.line_buf, line, len);
+	in.line_buf[len] = '\0';
+	return (in.line_buf);
+}
+
+/**
+ * inputRetire - keeps a block buffer alive until the next top-level line
+ * @buf: buffer that lines handed out for the current line may point into
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+static int inputRetire(char *buf)
+{
+	char **grown;
+
+	if (in.nretired % 8 == 0)
+	{
+		grown = realloc(in.retired, sizeof(char *) * (in.nretired + 8));
+		if (grown == NULL)
+			return (-1);
+		in.retired = grown;
+	}
+	in.retired[in.nretired++] = buf;
+	return (0);
+}
+
+/**
+ * inputFill - reads the next block of in.fd behind the unconsumed bytes
+ * @pinned: 1 if the current command line is still in use (e.g. a heredoc
+ * body is being read) and must not move
+ *
+ * Description: only the buffer holding the command line is pinned; once
+ * it is retired, the buffers after it hold nothing but continuation
+ * lines already consumed, so a body of any size streams through one
+ * buffer.
+ *
+ * Return: bytes read, 0 on end of input, -1 on error
+ */
+static ssize_t inputFill(int pinned)
+{
+	size_t cap = in.rcap ? in.rcap : INPUT_BLOCK, pending;
+	char *buf;
+	ssize_t n;
+
+	pinned = pinned && in.rbuf == in.line_home;
+	pending = in.rend - in.rstart;
+	if (!pinned && in.rstart > 0) /* nobody points into the buffer */
+	{
+		memmove(in.rbuf, in.rbuf + in.rstart, pending);
+		in.rend = pending;
+		in.rstart = 0;
+	}
+	if (in.rbuf == NULL || in.rend + 1 >= in.rcap) /* keep room for a NUL */
+	{
+		if (pending + 1 >= cap) /* one line fills the whole buffer */
+			cap *= 2;
+		buf = malloc(cap);
+		if (buf == NULL)
+			return (-1);
+		if (in.rbuf != NULL)
+			memcpy(buf, in.rbuf + in.rstart, pending);
+		in.rend = pending;
+		in.rstart = 0;
+		if (pinned && in.rbuf != NULL)
+		{
+			if (inputRetire(in.rbuf) == -1)
+			{
+				free(buf);
+				return (-1);
+			}
+		}
+		else
+			free(in.rbuf);
+		in.rbuf = buf;
+		in.rcap = cap;
+	}
+
+	do
+		n = read(in.fd, in.rbuf + in.rend, in.rcap - in.rend - 1);
+	while (n == -1 && errno == EINTR);
+	if (n > 0)
+		in.rend += n;
+	return (n);
+}
+
+/**
+ * inputStdinLine - splits the next line out of the stdin block buffer
+ * @pinned: see inputFill()
+ *
+ * Return: the line, NUL terminated in place, NULL at the end of input
+ */
+static char *inputStdinLine(int pinned)
+{
+	char *line, *newline;
+	ssize_t n;
+
+	while (1)
+	{
+		if (in.rend > in.rstart)
+		{
+			line = in.rbuf + in.rstart;
+			newline = memchr(line, '\n', in.rend - in.rstart);
+			if (newline != NULL)
+			{
+				*newline = '\0';
+				in.rstart = newline - in.rbuf + 1;
+				return (line);
+			}
+		}
+		n = inputFill(pinned);
+		if (n > 0)
+			continue;
+		if (n == -1 || in.rend == in.rstart) /* error, or nothing left */
+			return (NULL);
+		line = in.rbuf + in.rstart; /* last line has no newline */
+		in.rbuf[in.rend] = '\0';
+		in.rstart = in.rend;
+		return (line);
+	}
+}
+
+/**
+ * inputReadLine - reads the next command line
+ *
+ * Description: stdin is read in large blocks and lines are split in place,
+ * so there is no read() per line; see inputSync() for how children still
+ * see the right data. From a script the line is taken in place from the
+ * mapping. The trailing newline is removed either way.
+ *
+ * Return: the line (owned by the input layer, valid until the next call),
+ * NULL on end of input
+ */
+char *inputReadLine(void)
+{
+	char *line;
+
+	while (in.nretired > 0) /* nothing from the previous line is in use */
+		free(in.retired[--in.nretired]);
+
+	if (in.mode != INPUT_STDIN)
+		return (inputScriptLine());
+	line = inputStdinLine(0);
+	in.line_home = in.rbuf;
+	return (line);
+}
+
+/**
+ * inputReadContinuation - reads one more line that belongs to the current
+ * command line (e.g. a heredoc body line)
+ *
+ * Description: unlike inputReadLine(), the current command line stays
+ * valid; the continuation line itself only until the next call.
+ *
+ * Return: the line, valid until the next call, NULL on end of input
+ */
+char *inputReadContinuation(void)
+{
+	if (in.mode != INPUT_STDIN)
+		return (inputScriptLine());
+	return (inputStdinLine(1));
+}
+
+/**
+ * inputSync - hands read-ahead stdin bytes back before a child may read
+ *
+ * Description: when stdin is seekable, the file offset is moved back to
+ * the first byte after the current command, the way POSIX shells do, so
+ * a command like "head -1" sees the next line of the script instead of
+ * whatever followed our last block read. Pipes and terminals cannot seek;
+ * there the read-ahead stays with the shell.
+ */
+void inputSync(void)
+{
+	size_t unread = in.rend - in.rstart;
+
+	if (in.mode != INPUT_STDIN || in.fd != STDIN_FILENO || unread == 0)
+		return; /* children never read a script's own descriptor */
+	if (in.seekable == -1)
+		in.seekable = lseek(STDIN_FILENO, 0, SEEK_CUR) != -1;
+	if (!in.seekable)
+		return;
+	if (lseek(STDIN_FILENO, -(off_t)unread, SEEK_CUR) != -1)
+		in.rstart = in.rend; /* read again from there next time */
+}
+
+/**
+ * inputAtEnd - tells whether the line just read was the last one
+ *
+ * Description: only known without blocking for a script or -c string;
+ * trailing blank lines do not count.
+ *
+ * Return: 1 if no command can follow, 0 if one may (always 0 for stdin)
+ */
+int inputAtEnd(void)
+{
+	size_t i;
+
+	if (in.mode == INPUT_STDIN)
+		return (0);
+	for (i = in.pos; i < in.size; i++)
+		if (in.map[i] != '\n' && in.map[i] != ' ' && in.map[i] != '\t')
+			return (0);
+	return (1);
+}
+
+/**
+ * inputIsTerminal - tells whether a user types the command lines
+ *
+ * Return: 1 for a terminal on stdin, 0 for a script, -c or a pipe
+ */
+int inputIsTerminal(void)
+{
+	return (in.mode == INPUT_STDIN && isatty(in.fd));
+}
+
+/**
+ * inputDestroy - frees the input buffers and unmaps the script
+ */
+void inputDestroy(void)
+{
+	while (in.nretired > 0)
+		free(in.retired[--in.nretired]);
+	free(in.retired);
+	in.retired = NULL;
+	free(in.rbuf);
+	in.rbuf = NULL;
+	in.rcap = 0;
+	in.rstart = 0;
+	in.rend = 0;
+	free(in.line_buf);
+	in.line_buf = NULL;
+	in.line_cap = 0;
+	if (in.fd != STDIN_FILENO) /* a script read in blocks */
+		close(in.fd);
+	in.fd = STDIN_FILENO;
+	if (in.map != NULL && in.mode == INPUT_SCRIPT) /* -c string is argv's */
+		munmap(in.map, in.size);
+	in.map = NULL;
+	in.size = 0;
+	in.pos = 0;
+}
@@ -0,0 +1,254 @@
+#include "main.h"
+#include <sched.h>
+#include <signal.h>
+
+/*
+ * Launch layer: every external command is started here.
+ *
+ * fork() copies the shell's page tables, which costs more the bigger the
+ * heap gets. clone(CLONE_VM | CLONE_VFORK) instead runs the child on the
+ * shell's own memory and suspends the shell until the child execs or
+ * exits, the way posix_spawn() does. posix_spawn() itself cannot be used:
+ * pathExec() launches through a PATH directory's fd with execveat().
+ *
+ * Because the memory is shared, the child only makes system calls: no
+ * stdio, no malloc. When a redirection or the exec fails, it writes
+ * errno and the failing step to a close-on-exec pipe and exits; the
+ * parent reports the real error. A successful exec closes the pipe, so
+ * the parent reads nothing.
+ *
+ * Builtins inside a pipeline run shell code instead of an exec, so
+ * launchBuiltin() gives them a real fork().
+ */
+
+#define LAUNCH_STACK_SIZE (64 * 1024)
+#define LAUNCH_EXEC -1 /* step reported by the child: the exec failed */
+#define LAUNCH_DUP -2  /* connecting fd_in or fd_out failed */
+
+/* one child runs at a time on it: the parent waits until it execs */
+static char launch_stack[LAUNCH_STACK_SIZE] __attribute__((aligned(16)));
+
+/**
+ * launchDup - makes fd the child's descriptor target
+ * @fd: descriptor, -1 to leave target alone
+ * @target: STDIN_FILENO or STDOUT_FILENO
+ *
+ * Return: 0 on success, -1 with errno set on failure
+ */
+static int launchDup(int fd, int target)
+{
+	if (fd == -1)
+		return (0);
+	if (fd == target) /* dup2 would keep close-on-exec set */
+		return (fcntl(fd, F_SETFD, 0));
+	return (dup2(fd, target) == -1 ? -1 : 0);
+}
+
+/**
+ * launchChild - runs in the child on launch_stack: connects the
+ * descriptors, applies the redirections and execs
+ * @arg: the launch_t
+ *
+ * Return: never returns, exits 127 after reporting a failure
+ */
+static int launchChild(void *arg)
+{
+	launch_t *job = arg;
+	int report[2] = {0, LAUNCH_DUP};
+
+	if (launchDup(job->fd_in, STDIN_FILENO) == 0 &&
+		launchDup(job->fd_out, STDOUT_FILENO) == 0)
+	{
+		if (redirApply(job->redirs, NULL, &report[1]) == 0)
+		{
+			report[1] = LAUNCH_EXEC;
+			pathExec(job->path, job->argv, job->envp);
+		}
+	}
+	report[0] = errno;
+	while (write(job->report_fd, report, sizeof(report)) == -1 &&
+		   errno == EINTR)
+		;
+	_exit(127);
+}
+
+/**
+ * launchReport - prints the error a child reported
+ * @job: the command
+ * @err: errno from the child
+ * @step: LAUNCH_EXEC, LAUNCH_DUP or the index of the failing redirection
+ *
+ * Return: the exit status for the command
+ */
+static int launchReport(launch_t *job, int err, int step)
+{
+	redir_t *r = job->redirs;
+
+	if (step >= 0)
+	{
+		for (; step > 0 && r->next != NULL; step--)
+			r = r->next;
+		redirError(r, err);
+		return (2);
+	}
+	if (step == LAUNCH_DUP)
+	{
+		fprintf(stderr, "%s: 1: dup2: %s\n", shellName(), strerror(err));
+		return (2);
+	}
+	if (err == ENOENT || err == ENOTDIR) /* binary vanished since lookup */
+	{
+		fprintf(stderr, "%s: 1: %s: not found\n", shellName(),
+				job->argv[0]);
+		hashRemove(job->argv[0]); /* search PATH again next time */
+		return (127);
+	}
+	if (err == EACCES)
+	{
+		fprintf(stderr, "%s: 1: %s: Permission denied\n", shellName(),
+				job->argv[0]);
+		hashRemove(job->argv[0]);
+		return (126);
+	}
+	fprintf(stderr, "%s: 1: %s: %s\n", shellName(), job->argv[0],
+			strerror(err));
+	return (126);
+}
+
+/**
+ * launchSpawn - starts an external command
+ * @job: the command; fd_in and fd_out stay open in the shell
+ *
+ * Description: descriptors the child must not keep, such as the other
+ * ends of pipes, should be close-on-exec.
+ *
+ * Return: the child's pid; -1 after reporting the error, with
+ * job->status set to the command's exit status
+ */
+pid_t launchSpawn(launch_t *job)
+{
+	int report_pipe[2], report[2];
+	ssize_t n;
+	pid_t pid;
+
+	job->status = 0;
+	getPathTable(); /* built here, the child must not allocate */
+	job->envp = envGetEnvp();
+	if (pipe2(report_pipe, O_CLOEXEC) == -1)
+	{
+		perror("pipe");
+		job->status = 2;
+		return (-1);
+	}
+	job->report_fd = report_pipe[1];
+	if (job->redirs != NULL) /* out of the way of e.g. "3>file" */
+		job->report_fd = fdReserve(report_pipe[1]);
+	if (job->report_fd == -1)
+	{
+		perror("pipe");
+		close(report_pipe[0]);
+		job->status = 2;
+		return (-1);
+	}
+	pid = clone(launchChild, launch_stack + LAUNCH_STACK_SIZE,
+				CLONE_VM | CLONE_VFORK | SIGCHLD, job);
+	close(job->report_fd);
+	if (pid == -1)
+	{
+		perror("clone");
+		close(report_pipe[0]);
+		job->status = 2;
+		return (-1);
+	}
+
+	do /* the child has exec'd or exited by now, this never blocks */
+		n = read(report_pipe[0], report, sizeof(report));
+	while (n == -1 && errno == EINTR);
+	close(report_pipe[0]);
+	if (n != sizeof(report))
+		return (pid); /* exec succeeded and closed the pipe */
+
+	launchWait(pid); /* reap the child that failed */
+	job->status = launchReport(job, report[0], report[1]);
+	return (-1);
+}
+
+/**
+ * launchBuiltin - runs a builtin in a forked child, for a pipeline stage
+ * that is not the last one
+ * @job: the command; path is unused
+ * @fd_other: the shell's read end of the stage's own output pipe, -1 if
+ * none
+ *
+ * Description: a builtin runs shell code, not an exec, so this child is
+ * a real fork() and keeps none of the shell's pipe ends: holding the read
+ * end of its own output would keep it writing after the reader exits.
+ *
+ * Return: the child's pid; -1 after reporting the error, with
+ * job->status set
+ */
+pid_t launchBuiltin(launch_t *job, int fd_other)
+{
+	int failed, status;
+	redir_t *r;
+	pid_t pid;
+
+	fflush(stdout); /* the child would write the shell's buffer again */
+	pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		job->status = 2;
+		return (-1);
+	}
+	if (pid > 0)
+		return (pid);
+
+	status = 2;
+	if (launchDup(job->fd_in, STDIN_FILENO) == -1 ||
+		launchDup(job->fd_out, STDOUT_FILENO) == -1)
+		perror("dup2");
+	else
+	{
+		if (job->fd_in > STDIN_FILENO)
+			close(job->fd_in);
+		if (job->fd_out > STDOUT_FILENO)
+			close(job->fd_out);
+		if (fd_other != -1)
+			close(fd_other);
+		if (redirApply(job->redirs, NULL, &failed) == -1)
+		{
+			for (r = job->redirs; failed > 0; failed--)
+				r = r->next;
+			redirError(r, errno);
+		}
+		else
+			status = builtinStatus(customCmd(job->argv, 0), job->argv);
+	}
+	fflush(stdout);
+	_exit(status); /* not exit(): nothing of the shell's is torn down */
+}
+
+/**
+ * launchWait - waits for a child started by launchSpawn()
+ * @pid: the child
+ *
+ * Return: its exit status, 128 + the signal number if it was killed,
+ * -1 if waitpid failed
+ */
+int launchWait(pid_t pid)
+{
+	int status;
+
+	while (waitpid(pid, &status, 0) == -1)
+	{
+		if (errno != EINTR)
+		{
+			perror("waitpid");
+			return (-1);
+		}
+	}
+	if (WIFSIGNALED(status))
+		return (128 + WTERMSIG(status));
+	return (WEXITSTATUS(status));
+}
@@ -0,0 +1,149 @@
+#include "main.h"
+
+static token_t *lex_tokens; /* per-line scratch, see lexLine */
+static int lex_cap;
+
+/**
+ * lexPush - appends a token to the scratch stream
+ * @count: number of tokens already in the stream, incremented
+ * @type: token type
+ * @text: word text or operator spelling
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+static int lexPush(int *count, token_type_t type, char *text)
+{
+	token_t *grown;
+	int cap;
+
+	if (*count >= lex_cap) /* room for the token or the final TOK_EOF */
+	{
+		cap = lex_cap ? lex_cap * 2 : 64;
+		grown = realloc(lex_tokens, cap * sizeof(token_t));
+		if (grown == NULL)
+			return (-1);
+		lex_tokens = grown;
+		lex_cap = cap;
+	}
+	lex_tokens[*count].type = type;
+	lex_tokens[*count].text = text;
+	(*count)++;
+	return (0);
+}
+
+/**
+ * lexOperator - recognizes the operator starting at p
+ * @p: current position in the line
+ * @len: set to the operator's length in bytes
+ *
+ * Description: a lone '&' is not an operator, it stays part of a word;
+ * after '<' or '>' it makes the duplicating <& and >&.
+ *
+ * Return: the operator's type, TOK_WORD if p does not start one
+ */
+static token_type_t lexOperator(const char *p, int *len)
+{
+	*len = p[0] == p[1] ? 2 : 1;
+	switch (p[0])
+	{
+	case '|':
+		return (*len == 2 ? TOK_OR_IF : TOK_PIPE);
+	case '&':
+		return (*len == 2 ? TOK_AND_IF : TOK_WORD);
+	case ';':
+		*len = 1;
+		return (TOK_SEMI);
+	case '<':
+		if (p[1] == '&')
+		{
+			*len = 2;
+			return (TOK_LESSAND);
+		}
+		return (*len == 2 ? TOK_DLESS : TOK_LESS);
+	case '>':
+		if (p[1] == '&')
+		{
+			*len = 2;
+			return (TOK_GREATAND);
+		}
+		return (*len == 2 ? TOK_DGREAT : TOK_GREAT);
+	}
+	return (TOK_WORD);
+}
+
+/**
+ * lexLine - splits a command line into typed tokens
+ * @line: the line; word ends are NUL terminated in place
+ * @count: set to the number of tokens, not counting the final TOK_EOF
+ *
+ * Description: every byte is looked at once. Words point into line and
+ * operators to their static spelling, so nothing is copied. The array is
+ * scratch memory shared by every call: it is
+ * only valid until the next call and callers must not free it.
+ *
+ * Return: token array ended by TOK_EOF, NULL on malloc failure
+ */
+token_t *lexLine(char *line, int *count)
+{
+	static char *const spelling[] = {NULL, "|", "&&", "||", ";", "<", ">",
+									 ">>", "<<", "<&", ">&", NULL, NULL};
+	token_type_t type;
+	int len, in_word = 0;
+	char *p = line, *digits;
+
+	*count = 0;
+	while (*p != '\0')
+	{
+		if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == '\a')
+		{
+			*p++ = '\0';
+			in_word = 0;
+			continue;
+		}
+		type = lexOperator(p, &len);
+		if (type != TOK_WORD)
+		{
+			*p = '\0'; /* ends the word before it, if any */
+			if (lexPush(count, type, spelling[type]) == -1)
+				return (NULL);
+			p += len;
+			in_word = 0;
+			continue;
+		}
+		if (!in_word)
+		{
+			for (digits = p; *digits >= '0' && *digits <= '9'; digits++)
+				;
+			if (digits > p && (*digits == '<' || *digits == '>')) /* 2>f */
+			{
+				if (lexPush(count, TOK_IO_NUMBER, p) == -1)
+					return (NULL); /* the operator NUL terminates it */
+				p = digits;
+				continue;
+			}
+			if (lexPush(count, TOK_WORD, p) == -1)
+				return (NULL);
+			in_word = 1;
+			if (digits > p) /* already known not to be operators */
+			{
+				p = digits;
+				continue;
+			}
+		}
+		p++;
+	}
+	if (lexPush(count, TOK_EOF, NULL) == -1)
+		return (NULL);
+	(*count)--;
+	return (lex_tokens);
+}
+
+/**
+ * lexDestroy - frees the scratch token array of lexLine
+ */
+void lexDestroy(void)
+{
+	free(lex_tokens);
+	lex_tokens = NULL;
+	lex_cap = 0;
+}
@@ -110,6 +110,12 @@ run_test 34 "echo hello | tr 'a-z' 'A-Z' && echo done" "HELLO\ndone" 0
 run_test 35 "echo hello | tr 'a-z' 'A-Z' || echo done" "HELLO" 0
 run_test 36 "ls -la | grep Makefile && echo Found it!" "Found it!" 0
 
+# Builtins right after a longer line: argv ends at its NULL, nothing of
+# the previous line may show through
+run_test 37 $'echo a b c d e\nsetenv HOME /tmp\necho a b c d e\ncd\npwd' "^/tmp$" 0
+run_test 38 $'echo a b c d e f\nsetenv' "setenv: usage" 2
+run_test 39 $'echo a b c d e f\nsetenv NAME' "setenv: usage" 2
+
 # Clean up after the script
 rm -f output.txt test.txt
 
@@ -119,7 +125,7 @@ echo "All tests completed."
 exit_code=0
 
 #Check exit code
-for i in $(seq 1 36);
+for i in $(seq 1 39);
 do
   if [ ! -f "test_result_$i" ]; then
     exit_code=1
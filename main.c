@@ -1,26 +1,59 @@
 #include "main.h"
 #include <signal.h>
 
+static const char *shell_name = "hsh"; /* $0, see shellName() */
+
 /**
  * main - starts the program and the loop
  * @argc: number of arguments
- * @argv: array of arguments
+ * @argv: array of arguments, argv[1] is an optional script to run, or
+ * -c followed by a command string and an optional name for error messages
  *
  * Return: 0
  */
 int main(int argc, char *argv[])
 {
-	int isInteractive = isatty(STDIN_FILENO);
+	int isInteractive;
 
 	/* ------------------- On entry - one time execution ------------------- */
-	(void)argc;
+	shell_name = argv[0];
+	if (argc > 1 && _strcmp(argv[1], "-c") == 0) /* hsh -c 'cmd' [name] */
+	{
+		if (argc < 3)
+		{
+			fprintf(stderr, "%s: 0: -c requires an argument\n", shell_name);
+			return (2);
+		}
+		if (argc > 3)
+			shell_name = argv[3]; /* $0 of the command string */
+		/* one-shot: no banner, prompt, warm-up or PATH watches */
+		inputOpenString(argv[2]);
+		pathWatchDisable();
+		initialize_environ();
+		shellLoop(0);
+		return (EXIT_SUCCESS);
+	}
+
+	isInteractive = isatty(STDIN_FILENO);
+	if (argc > 1) /* hsh script: read commands from the file, not stdin */
+	{
+		if (inputOpenScript(argv[1]) == -1)
+		{
+			fprintf(stderr, "%s: 0: cannot open %s: %s\n", shell_name,
+					argv[1], strerror(errno));
+			return (127);
+		}
+		isInteractive = 0;
+	}
 	if (isInteractive)
 		printf("%sWelcome to the %sGates Of Shell%s. Type 'exit' to quit.\n\n",
 			   CLR_YELLOW_BOLD, CLR_RED_BOLD, CLR_YELLOW_BOLD);
 	/* --------------------------------------------------------------------- */
 	initialize_environ(); /* makes environ dynamically allocated */
+	if (isInteractive)
+		getPathTable(); /* parse PATH before the first prompt, not after */
 
-	shellLoop(isInteractive, argv); /* main shell loop */
+	shellLoop(isInteractive); /* main shell loop */
 
 	/* ------------------- On exit - one time execution ------------------- */
 	if (isInteractive)
@@ -33,130 +66,77 @@ int main(int argc, char *argv[])
 
 /**
  * executeIfValid - check if a command is a valid custom or built-in command;
- * run the command if it is valid; if child process fails,stop it
- * from re-entering loop
+ * run the command if it is valid
  *
  * @isAtty: result of isatty(), 1 if interactive, 0 otherwsie
- * @argv: carrier of filename in [0]
- * @tokens: array of strings of user inputs delimited by spaces
+ * @cmd: simple command from the parsed line
+ * @last: 1 if nothing on the line runs after this command
+ *
+ * Return: the command's exit status
  */
-void executeIfValid(int isAtty, char *const *argv, char **tokens, char *input)
+int executeIfValid(int isAtty, cmd_t *cmd, int last)
 {
-	int custom_cmd_rtn;
+	char **tokens = cmd->argv;
+	launch_t job = {0};
+
 	if (tokens[0] == NULL)
 	{
-		return; /*  Empty command - just return to the prompt */
+		return (redirTouch(cmd->redirs)); /* "> file" only creates file */
 	}
 
-	/* Handle built-in commands */
-	custom_cmd_rtn = customCmd(tokens, isAtty, input);
-	if (custom_cmd_rtn)
+	/* built-ins run in the shell, so cd and setenv last for the line */
+	if (builtinFind(tokens[0]) != NULL)
 	{
-		if (custom_cmd_rtn == 2) /* false directory */
-			fprintf(stderr, "%s: 1: cd: can't cd to %s\n", argv[0], tokens[1]);
-		else if (custom_cmd_rtn == 3) /* too many arguments */
-			fprintf(stderr, "%s: 1: cd: too many arguments\n", argv[0]);
-
-		if ((custom_cmd_rtn == -1) && !isAtty)
-		{
-			resetAll(tokens, input, NULL);
-			safeExit(EXIT_SUCCESS);
-		}
-		return;
+		job.argv = tokens;
+		job.redirs = cmd->redirs; /* undone once the built-in returns */
+		job.fd_in = job.fd_out = -1;
+		return (runBuiltin(&job, isAtty));
 	}
 
 	/* Not a built-in command, try executing as external command*/
-	/* *** CHECK FOR EMPTY COMMAND HERE *** */
-
 	char *full_path = findPath(tokens[0]);
 	if (full_path == NULL)
 	{
-		fprintf(stderr, "%s: 1: %s: not found\n", argv[0], tokens[0]);
-		if (!isAtty)
-		{
-			resetAll(tokens, input, NULL);
-			safeExit(127); /* Standard not found error status */
-		}
-		return; /* Return after handling "not found" */
+		fprintf(stderr, "%s: 1: %s: not found\n", shellName(), tokens[0]);
+		return (127); /* Standard not found error status */
 	}
 
-	int run_cmd_rtn = execute_command(full_path, tokens); /* pass tokens */
-	free(full_path);
-
-	if (run_cmd_rtn != 0)
-	{
-		/* Handle errors from execute_command */
-		if (run_cmd_rtn == 127)
-		{
-			/* here for clarity and in case execute_command changes */
-			fprintf(stderr, "%s: 1: %s: not found\n", argv[0], tokens[0]);
-		}
-		else if (run_cmd_rtn == -1)
-		{
-			perror("fork failed");
-		}
-		else if (run_cmd_rtn == 2)
-			;
-		else
-		{
-			/* Other execve errors: use perror to print a descriptive message */
-			fprintf(stderr, "%s: 1: %s: ", argv[0], tokens[0]);
-			errno = run_cmd_rtn; /* Set errno, to error code */
-			perror("");			 /* Use an empty string with perror */
-		}
+	/* last command of -c or a script, nothing to restore afterwards */
+	if (last && !isAtty && cmd->redirs == NULL && inputAtEnd())
+		execute_tail(full_path, tokens); /* only returns on failure */
 
-		if (!isAtty)
-		{
-			/* use run_cmd_rtn exit status. */
-			resetAll(tokens, input, NULL);
-			safeExit(run_cmd_rtn);
-		}
-	}
+	/* the launch layer reports commands that fail to start */
+	int run_cmd_rtn = execute_command(full_path, tokens, cmd->redirs);
+	free(full_path);
+	return (run_cmd_rtn);
 }
 
 /**
- * resetAll - frees all dynamically allotted memory to reset for next cmd
- * @tokens: array of strings needing free()
- * ...: list of variables to free
- * NOTE: must be called with a final paramater VOID
+ * shellName - the name the shell reports errors under
+ *
+ * Return: argv[0], or the name given after hsh -c 'cmd'
  */
-void resetAll(char **tokens, ...)
+const char *shellName(void)
 {
-	va_list vars;
-	char *free_me;
-
-	if (tokens != NULL)
-		free(tokens);
-	va_start(vars, tokens);
-	free_me = va_arg(vars, char *);
-
-	while (free_me != NULL)
-	{
-		if (free_me)
-			free(free_me);
-		free_me = NULL;
-		free_me = va_arg(vars, char *);
-	}
-	va_end(vars);
+	return (shell_name);
 }
 
 /**
- * safeExit - exits after freeing environ
+ * safeExit - exits after freeing the environment and caches
  * @exit_code: exit code for exit()
  *
  * Return: void
  */
 void safeExit(int exit_code)
 {
-	int i;
-
-	if (environ)
-	{
-		for (i = 0; environ[i] != NULL; i++)
-			free(environ[i]);
-		free(environ);
-		environ = NULL;
-	}
+	envTableDestroy(); /* also drops environ, a view of the store */
+	inputDestroy();
+	lexDestroy();
+	arenaDestroy();
+	hashClear();
+	missClear();
+	destroyPathTable();
+	promptDestroy();
 
 	exit(exit_code);
 }
@@ -2,6 +2,7 @@
 #define MAIN_H
 
 /* ↓ LIBRARIES ↓ */
+#define _GNU_SOURCE	   /* For O_PATH, execveat() */
 #include <ctype.h>	   /* For isspace() in trim_whitespace() */
 #include <errno.h>	   /* For errno */
 #include <fcntl.h>	   /* For open(), fcntl() - if you use them */
@@ -20,33 +21,438 @@
 /* ↓ STRUCTS AND MISC ↓ */
 
 /**
- * struct path_s - Singly linked list for PATH environment variable
- * @directory: String of directory
- * @next: Next location directory
+ * struct path_dir_s - One directory of the PATH environment variable
+ * @directory: Directory string, points into the table's arena
+ * @len: Precomputed length of directory
+ * @fd: O_PATH handle to the directory, -1 if it could not be opened
+ * @wd: inotify watch descriptor, -1 if the directory is polled instead
+ * @mtime: Last seen modification time, see pathDirsEpoch()
  *
- * Description: Singly linked list node structure
+ * Description: Element of path_table_t
  */
-typedef struct path_s
+typedef struct path_dir_s
 {
 	char *directory;
-	struct path_s *next;
-} path_t;
+	size_t len;
+	int fd;
+	int wd;
+	struct timespec mtime;
+} path_dir_t;
 
 /**
- * typedef enum SeparatorType - Enumeration for command separators
- * @SEP_NONE: No separator.
- * @SEP_SEMICOLON: Semicolon separator (;).
- * @SEP_AND: Logical AND separator (&&).
- * @SEP_OR: Logical OR separator (||).
+ * struct path_table_s - PATH parsed once per change, in PATH order
+ * @arena: Single allocation holding dirs followed by the directory strings
+ * @dirs: Array of directories
+ * @count: Number of directories
+ * @valid: 0 if PATH must be parsed again before use
+ * @generation: Bumped every time PATH itself changes
+ * @dir_epoch: Bumped every time a directory's mtime is seen to change
+ * @dirs_fresh: 1 if mtimes were checked since the last command ran
+ * @watch_fd: inotify descriptor watching the directories, -1 if none
+ *
+ * Description: Rebuilt lazily after pathChanged(), see path_table.c
+ */
+typedef struct path_table_s
+{
+	char *arena;
+	path_dir_t *dirs;
+	size_t count;
+	int valid;
+	unsigned long generation;
+	unsigned long dir_epoch;
+	int dirs_fresh;
+	int watch_fd;
+} path_table_t;
+
+/**
+ * struct cmd_hash_s - Remembered command name to absolute path mapping
+ * @name: Command name as typed
+ * @path: Absolute path the name resolved to
+ * @hits: Number of times the entry was used
+ * @next: Next node in the same bucket
+ *
+ * Description: Chained hash table node, see cmd_hash.c
+ */
+typedef struct cmd_hash_s
+{
+	char *name;
+	char *path;
+	unsigned int hits;
+	struct cmd_hash_s *next;
+} cmd_hash_t;
+
+/**
+ * struct cmd_hash_stats_s - Command resolution counters, shown by "hash -s"
+ * @hits: Lookups served from the hash
+ * @negative_hits: Lookups served from the negative cache
+ * @misses: Lookups that had to walk PATH
+ * @evictions: Hash entries dropped (stale, PATH change, hash -r)
+ */
+typedef struct cmd_hash_stats_s
+{
+	unsigned long hits;
+	unsigned long negative_hits;
+	unsigned long misses;
+	unsigned long evictions;
+} cmd_hash_stats_t;
+
+/**
+ * struct cmd_miss_s - Remembered "not found" result
+ * @name: Command name that was not found, NULL if slot is empty
+ * @generation: PATH generation the miss was recorded under
+ * @dir_epoch: PATH directory mtime epoch the miss was recorded under
+ *
+ * Description: Slot of the direct-mapped negative cache, see cmd_hash.c
+ */
+typedef struct cmd_miss_s
+{
+	char *name;
+	unsigned long generation;
+	unsigned long dir_epoch;
+} cmd_miss_t;
+
+/**
+ * struct env_slot_s - Open addressing slot of the environment index
+ * @hash: Hash of the variable name
+ * @index: Index of the variable in the store, -1 if the slot is empty
+ *
+ * Description: see env_table.c
+ */
+typedef struct env_slot_s
+{
+	unsigned int hash;
+	int index;
+} env_slot_t;
+
+/**
+ * enum prompt_seg_type_e - Kinds of compiled prompt segments
+ * @PS_TEXT: Literal text
+ * @PS_USER: User name (\u)
+ * @PS_HOST: Host name (\h)
+ * @PS_CWD: Current working directory (\w)
+ */
+typedef enum prompt_seg_type_e
+{
+	PS_TEXT,
+	PS_USER,
+	PS_HOST,
+	PS_CWD
+} prompt_seg_type_t;
+
+/**
+ * struct prompt_seg_s - One segment of the compiled prompt
+ * @type: What the segment expands to
+ * @text: Literal bytes for PS_TEXT, points into prompt_t.text
+ * @len: Number of literal bytes
+ */
+typedef struct prompt_seg_s
+{
+	prompt_seg_type_t type;
+	const char *text;
+	size_t len;
+} prompt_seg_t;
+
+/**
+ * struct prompt_s - Compiled prompt with its cached inputs and output
+ * @segs: Compiled PS1, NULL if it must be compiled again
+ * @nsegs: Number of segments
+ * @text: Literal text of the format with escapes resolved
+ * @user: Cached user name, NULL if stale
+ * @host: Cached host name, NULL if stale
+ * @cwd: Cached working directory
+ * @cwd_valid: 0 if cwd is stale
+ * @rendered: The finished prompt
+ * @len: Length of rendered
+ * @cap: Capacity of rendered
+ * @valid: 0 if rendered must be built again
+ *
+ * Description: see prompt.c
+ */
+typedef struct prompt_s
+{
+	prompt_seg_t *segs;
+	size_t nsegs;
+	char *text;
+	char *user;
+	char *host;
+	char cwd[PATH_MAX];
+	int cwd_valid;
+	char *rendered;
+	size_t len;
+	size_t cap;
+	int valid;
+} prompt_t;
+
+/**
+ * enum input_mode_e - Where command lines come from
+ * @INPUT_STDIN: Standard input, interactive or not, or a script that
+ * cannot be mapped (a pipe or device), read the same way in blocks
+ * @INPUT_SCRIPT: A script file given on the command line
+ * @INPUT_STRING: The command string given with -c
+ */
+typedef enum input_mode_e
+{
+	INPUT_STDIN,
+	INPUT_SCRIPT,
+	INPUT_STRING
+} input_mode_t;
+
+/**
+ * struct input_s - State of the input layer
+ * @mode: Current source
+ * @map: Private mapping of the script, or the -c string, NULL if none
+ * @size: Size of the script
+ * @pos: Offset of the next line in the script
+ * @line_buf: Buffer for a script's final line without a newline
+ * @line_cap: Capacity of line_buf
+ * @rbuf: Block buffer fd is read into
+ * @rcap: Capacity of rbuf
+ * @rstart: Offset of the first unconsumed byte in rbuf
+ * @rend: Offset one past the last byte read into rbuf
+ * @seekable: 1 if stdin can seek, 0 if not, -1 if not checked yet
+ * @retired: Old block buffers still referenced by the current line
+ * @nretired: Number of retired buffers
+ * @line_home: rbuf when the current command line was read; only that
+ * buffer is kept alive while continuation lines are read
+ * @fd: Descriptor the block reader reads, STDIN_FILENO unless a script
+ * cannot be mapped
+ *
+ * Description: see input.c
+ */
+typedef struct input_s
+{
+	input_mode_t mode;
+	char *map;
+	size_t size;
+	size_t pos;
+	char *line_buf;
+	size_t line_cap;
+	char *rbuf;
+	size_t rcap;
+	size_t rstart;
+	size_t rend;
+	int seekable;
+	char **retired;
+	size_t nretired;
+	char *line_home;
+	int fd;
+} input_t;
+
+/**
+ * enum token_type_e - Types of tokens produced by lexLine()
+ * @TOK_WORD: A word, command name or argument
+ * @TOK_PIPE: |
+ * @TOK_AND_IF: &&
+ * @TOK_OR_IF: ||
+ * @TOK_SEMI: ;
+ * @TOK_LESS: <
+ * @TOK_GREAT: >
+ * @TOK_DGREAT: >>
+ * @TOK_DLESS: <<
+ * @TOK_LESSAND: <&
+ * @TOK_GREATAND: >&
+ * @TOK_IO_NUMBER: Digits right before a redirection, the fd it changes
+ * @TOK_EOF: End of the line
+ */
+typedef enum token_type_e
+{
+	TOK_WORD,
+	TOK_PIPE,
+	TOK_AND_IF,
+	TOK_OR_IF,
+	TOK_SEMI,
+	TOK_LESS,
+	TOK_GREAT,
+	TOK_DGREAT,
+	TOK_DLESS,
+	TOK_LESSAND,
+	TOK_GREATAND,
+	TOK_IO_NUMBER,
+	TOK_EOF
+} token_type_t;
+
+#define TOK_BIT(type) (1u << (type))
+#define TOK_LIST_OPS (TOK_BIT(TOK_AND_IF) | TOK_BIT(TOK_OR_IF) | \
+					  TOK_BIT(TOK_SEMI))
+#define TOK_REDIRECTS (TOK_BIT(TOK_LESS) | TOK_BIT(TOK_GREAT) | \
+					   TOK_BIT(TOK_DGREAT) | TOK_BIT(TOK_DLESS) | \
+					   TOK_BIT(TOK_LESSAND) | TOK_BIT(TOK_GREATAND))
+
+/**
+ * struct token_s - One token of a command line
+ * @type: Token type
+ * @text: The word, NUL terminated inside the line, or the operator
  */
-typedef enum
+typedef struct token_s
 {
-	SEP_NONE,
-	SEP_SEMICOLON,
-	SEP_AND,
-	SEP_OR,
-	SEP_SEMI
-} SeparatorType;
+	token_type_t type;
+	char *text;
+} token_t;
+
+/**
+ * enum str_level_e - Implementations of the string scanning kernels
+ * @STR_SCALAR: One byte at a time
+ * @STR_SWAR: Eight bytes at a time in a 64-bit word
+ * @STR_SSE2: Sixteen bytes at a time (x86 only)
+ * @STR_AVX2: Thirty-two bytes at a time (x86 only)
+ */
+typedef enum str_level_e
+{
+	STR_SCALAR,
+	STR_SWAR,
+	STR_SSE2,
+	STR_AVX2
+} str_level_t;
+
+/**
+ * struct str_ops_s - One level's kernels, see string_kernels.c
+ * @len: strlen
+ * @chr: first byte equal to c, or the terminating NUL
+ * @cmp: strcmp
+ * @cspn: strcspn
+ */
+typedef struct str_ops_s
+{
+	size_t (*len)(const char *s);
+	const char *(*chr)(const char *s, int c);
+	int (*cmp)(const char *a, const char *b);
+	size_t (*cspn)(const char *s, const char *reject);
+} str_ops_t;
+
+/**
+ * struct arena_chunk_s - One block of the line arena
+ * @next: Next chunk, kept across resets
+ * @size: Usable bytes in data
+ * @used: Bytes handed out from data
+ * @data: The memory
+ */
+typedef struct arena_chunk_s
+{
+	struct arena_chunk_s *next;
+	size_t size;
+	size_t used;
+	char data[];
+} arena_chunk_t;
+
+/**
+ * struct arena_s - Bump allocator for everything parsed from one line
+ * @first: First chunk
+ * @cur: Chunk allocations come from
+ *
+ * Description: see arena.c
+ */
+typedef struct arena_s
+{
+	arena_chunk_t *first;
+	arena_chunk_t *cur;
+} arena_t;
+
+/* descriptors the shell keeps open for itself live at or above this one */
+/* (PATH handles, inotify, here documents...); redirections stop below it */
+#define SHELL_FD_MIN 10
+
+/**
+ * struct redir_s - One redirection of a simple command
+ * @fd: Descriptor it changes, 0 or 1 unless given as in 2>file
+ * @op: TOK_LESS, TOK_GREAT, TOK_DGREAT, TOK_DLESS, TOK_LESSAND or
+ * TOK_GREATAND
+ * @target: File name, the here document's delimiter, or for <& and >&
+ * the descriptor to copy or "-" to close fd
+ * @body_fd: Here document body, a pipe or memfd filled at parse time,
+ * -1 for other redirections
+ * @next: Next redirection, in command line order
+ */
+typedef struct redir_s
+{
+	int fd;
+	token_type_t op;
+	char *target;
+	int body_fd;
+	struct redir_s *next;
+} redir_t;
+
+/**
+ * struct cmd_s - A simple command
+ * @argv: NULL terminated words, pointing into the line; exactly one slot
+ * per word plus the NULL, from the reused arena, so nothing may be read
+ * past the NULL
+ * @redirs: Redirections, NULL if none
+ * @next: Next command of the pipeline, NULL for the last one
+ */
+typedef struct cmd_s
+{
+	char **argv;
+	redir_t *redirs;
+	struct cmd_s *next;
+} cmd_t;
+
+/**
+ * struct pipeline_s - A pipeline, one element of an and-or list
+ * @cmds: First command
+ * @ncmds: Number of commands
+ * @connector: TOK_SEMI, TOK_AND_IF or TOK_OR_IF: what comes before it
+ * @next: Next pipeline of the list, NULL for the last one
+ *
+ * Description: a command line is parsed into a list of pipelines; && and
+ * || have equal precedence, so the list is walked left to right.
+ */
+typedef struct pipeline_s
+{
+	cmd_t *cmds;
+	int ncmds;
+	token_type_t connector;
+	struct pipeline_s *next;
+} pipeline_t;
+
+/**
+ * struct launch_s - One external command for the launch layer
+ * @path: Full path returned by findPath()
+ * @argv: NULL terminated argv for the command
+ * @envp: Environment, filled in by launchSpawn()
+ * @redirs: Redirections, applied after fd_in and fd_out
+ * @fd_in: Descriptor that becomes the command's stdin, -1 to inherit
+ * @fd_out: Descriptor that becomes its stdout, -1 to inherit
+ * @report_fd: Write end of the error pipe, used by the child
+ * @status: Exit status to use when the launch fails, 0 otherwise
+ *
+ * Description: see launch.c
+ */
+typedef struct launch_s
+{
+	const char *path;
+	char **argv;
+	char **envp;
+	redir_t *redirs;
+	int fd_in;
+	int fd_out;
+	int report_fd;
+	int status;
+} launch_t;
+
+/**
+ * struct builtin_s - A command the shell runs itself
+ * @name: Command name
+ * @run: Handler, returns 1 on success (see customCmd)
+ */
+typedef struct builtin_s
+{
+	const char *name;
+	int (*run)(char **tokens, int interactive);
+} builtin_t;
+
+/**
+ * struct redir_save_s - A descriptor changed in the shell itself, to be
+ * put back once a builtin has run
+ * @fd: The descriptor
+ * @copy: Close-on-exec copy of what it was, -1 if it was closed
+ * @next: Saved before this one
+ */
+typedef struct redir_save_s
+{
+	int fd;
+	int copy;
+	struct redir_save_s *next;
+} redir_save_t;
 
 extern char **environ;		 /* The environment variables */
 extern char **saved_environ;
@@ -56,61 +462,129 @@ extern char **tokens;
 /* ↓ FUNCTION PROTOTYPES ↓ */
 
 /* --- Main Shell Loop and Control --- */
-void shellLoop(int isAtty, char *argv[]);
-void executeIfValid(int isAtty, char *const *argv, char **tokens, char *input);
+void shellLoop(int isAtty);
+int executeIfValid(int isAtty, cmd_t *cmd, int last);
+const char *shellName(void);
 void safeExit(int exit_code);
-void printPrompt(int isAtty, char *user, char *hostname, char *path);
+void printPrompt(void);
+void promptEnvChanged(const char *name);
+void promptDestroy(void);
+
+/* --- Input --- */
+int inputOpenScript(const char *path);
+void inputOpenString(char *command);
+char *inputReadLine(void);
+char *inputReadContinuation(void);
+void inputSync(void);
+int inputAtEnd(void);
+int inputIsTerminal(void);
+void inputDestroy(void);
 
 /* --- Command Parsing --- */
-char **parse_command(char *command);
-int split_command_line_on_pipe(char *input, char ***commands, int *num_commands);
-char *trim_whitespace(char *str);
+token_t *lexLine(char *line, int *count);
+void lexDestroy(void);
+int parseLine(token_t *tokens, int count, pipeline_t **list);
+void parseRelease(pipeline_t *list);
+void *arenaAlloc(size_t size);
+void arenaReset(void);
+void arenaDestroy(void);
 
 /* --- Command Execution --- */
-int execute_command(const char *commandPath, char **arguments);
-void execute_pipe_command(char **commands, int num_commands);
-void execute_logical_commands(char *line);
-void execute_commands_separated_by_semicolon(char *line);
+int execute_list(pipeline_t *list, int isAtty);
+int execute_command(const char *commandPath, char **arguments,
+					redir_t *redirs);
+void execute_tail(const char *commandPath, char **arguments);
+int execute_pipe_command(pipeline_t *pipeline, int isAtty);
+int runBuiltin(launch_t *job, int isAtty);
+pid_t launchSpawn(launch_t *job);
+pid_t launchBuiltin(launch_t *job, int fd_other);
+int launchWait(pid_t pid);
+int fdReserve(int fd);
+int redirApply(redir_t *redirs, redir_save_t **saved, int *failed);
+int redirSave(int fd, redir_save_t **saved);
+void redirRestore(redir_save_t *saved);
+int redirTouch(redir_t *redirs);
+void redirError(redir_t *r, int err);
 
 /* --- Built-in Command Handlers --- */
-int customCmd(char **tokens, int interactive, char *input);
-int ifCmdCd(char **tokens);
-int ifCmdEnv(char **tokens);
-int ifCmdExit(char **tokens, int interactive, char *input);
-int ifCmdSelfDestruct(char **tokens);
-int ifCmdSetEnv(char **tokens);
-int ifCmdUnsetEnv(char **tokens);
+int customCmd(char **tokens, int interactive);
+const builtin_t *builtinFind(const char *name);
+int builtinStatus(int rtn, char **tokens);
+int ifCmdCd(char **tokens, int interactive);
+int ifCmdEnv(char **tokens, int interactive);
+int ifCmdExit(char **tokens, int interactive);
+int ifCmdSelfDestruct(char **tokens, int interactive);
+int ifCmdSetEnv(char **tokens, int interactive);
+int ifCmdUnsetEnv(char **tokens, int interactive);
+int ifCmdHash(char **tokens, int interactive);
 void selfDestruct(int countdown);
-void freeIfCmdCd(char *previous_cwd, char *home, char *pwd);
 
 /* --- Environment Variable Handling --- */
 char *_getenv(const char *name);
 int _setenv(const char *name, const char *value, int overwrite);
 int _unsetenv(const char *name);
 void initialize_environ(void);
-path_t *buildListPath(void);
+int envTableBuild(void);
+int envTableImport(char **src);
+int envTableFind(const char *name, size_t len);
+char *envTableGet(int index);
+void envTableReplace(int index, char *line);
+int envTableAppend(char *line);
+int envTableRemove(int index);
+int envTableCount(void);
+char **envGetEnvp(void);
+void envTableDestroy(void);
 char *findPath(char *name);
-void destroyListPath(path_t *h);
 char *getUser(void);
 char *getHostname(void);
 char* _strstr(char *sentence, char *word);
-int RightDirect(char *line);
-int DoubleRightDirect(char *line);
-int LeftDirect(char *line);
-int DoubleLeftDirect(char *line);
 int StreamDirect(char **tokens);
 int ifCmdEcho(char **tokens);
 size_t _strcspn(const char *str1, const char *str2);
 
+/* --- PATH Table --- */
+path_table_t *getPathTable(void);
+char *buildCandidate(const path_dir_t *dir, const char *name, size_t name_len,
+					 char *buf);
+int pathDirHasCommand(const path_dir_t *dir, const char *name);
+int pathExec(const char *commandPath, char **arguments, char **envp);
+void pathChanged(void);
+unsigned long pathDirsEpoch(void);
+void pathDirsStale(void);
+void destroyPathTable(void);
+void pathWatchStart(path_table_t *table);
+void pathWatchDisable(void);
+void pathWatchDir(path_table_t *table, path_dir_t *dir);
+void pathWatchDrain(void);
+
+/* --- Command Hash Cache --- */
+char *hashLookup(const char *name);
+char *hashHit(const char *name);
+int hashInsert(const char *name, const char *path);
+void hashRemove(const char *name);
+void hashClear(void);
+int missLookup(const char *name, unsigned long generation,
+			   unsigned long dir_epoch);
+void missInsert(const char *name, unsigned long generation,
+				unsigned long dir_epoch);
+void missRemove(const char *name);
+void missClear(void);
+void hashPrint(void);
+cmd_hash_stats_t *hashStats(void);
+
 /* --- Utility Functions --- */
 int isNumber(char *str);
 int _atoi_safe(const char *s);
-void resetAll(char **tokens, ...);
-void freeIfCmdCd(char *previous_cwd, char *home, char *pwd);
 int is_directory(char *fp);
 int isCommand(const char *fp);
 
 /* --- Custom String Functions (Keep these!) --- */
+size_t strScanLen(const char *s);
+const char *strScanChr(const char *s, int c);
+int strScanCmp(const char *a, const char *b);
+size_t strScanCspn(const char *s, const char *reject);
+str_level_t strKernelBest(void);
+int strKernelSelect(str_level_t level);
 char *_strtok_r(char *str, const char *delim, char **saveptr);
 char *_strcat(char *dest, const char *src);
 char *_strchr(const char *s, char c);
@@ -119,7 +593,6 @@ int _strcmp(const char *s1, const char *s2);
 char *_strcpy(char *dest, const char *src);
 char *_strdup(const char *str);
 int _strncmp(const char *s1, const char *s2, int n);
-void *_realloc_array(char **ptr, unsigned int new_size);
 int _build_path(const char *cwd, const char *rel_path, char *abs_path);
 
 #endif /* MAIN_H */
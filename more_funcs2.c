@@ -1,33 +1,31 @@
 #include "main.h"
 
 /**
- * freeIfCmdCd - frees previous_cwd, home, and pwd inn ifCmdCd
- * @previous_cwd: malloced string from _getenv("OLDPWD")
- * @home: malloced string from _getenv("HOME")
- * @pwd: malloced string form _getenv("PWD")
+ * _strstr - finds the first occurrence of word in sentence
+ * @sentence: string searched
+ * @word: string to find
  *
- * Return: void
+ * Description: candidates are found with the vector kernel that looks for
+ * word's first byte; only those are compared byte by byte.
+ *
+ * Return: start of the match, NULL if there is none
  */
-void freeIfCmdCd(char *previous_cwd, char *home, char *pwd)
-{
-	if (previous_cwd)
-		free(previous_cwd);
-	if (home)
-		free(home);
-	if (pwd)
-		free(pwd);
-}
-
 char* _strstr(char *sentence, char *word)
 {
 	if (!word)
 	{
 		return (sentence);
 	}
-	for (; *sentence; sentence++)
+	if (!*word)
+		return (*sentence ? sentence : NULL);
+	for (;; sentence++)
 	{
-		char *a = sentence;
-		char *b = word;
+		sentence = (char *)strScanChr(sentence, word[0]);
+		if (!*sentence)
+			return (NULL);
+
+		char *a = sentence + 1;
+		char *b = word + 1;
 
 		while (*a && *b && *a == *b)
 		{
@@ -37,21 +35,16 @@ char* _strstr(char *sentence, char *word)
 		if (!*b)
 			return (sentence);
 	}
-	return (NULL);
 }
 
+/**
+ * _strcspn - length of the leading part of str1 without any byte of str2
+ * @str1: string scanned
+ * @str2: bytes that end the span
+ *
+ * Return: the length
+ */
 size_t _strcspn(const char *str1, const char *str2)
 {
-	const char *s = str1;
-
-	while (*s)
-	{
-		for (const char *p = str2; *p; p++)
-		{
-			if (*s == *p)
-				return (s - str1);
-		}
-		s++;
-	}
-	return (s - str1);
+	return (strScanCspn(str1, str2));
 }
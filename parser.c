@@ -1,115 +1,375 @@
 #include "main.h"
 
+#include <sys/mman.h>
+
+#define HEREDOC_CHUNK 65536 /* body bytes gathered per write */
+
+static char heredoc_buf[HEREDOC_CHUNK]; /* body not yet written out */
+
 /**
- * split_command_line_on_pipe - Splits the command line into two commands
- *                              based on the pipe symbol without using strchr.
- * @line: The command line string.
- * @command1: Pointer to store the first command (before the pipe).
- * @command2: Pointer to store the second command (after the pipe).
+ * parseError - reports the token the parser did not expect
+ * @tok: offending token, TOK_EOF if the line ended too early
  *
- * Return: 0 if a pipe symbol is found and the line is split, -1 otherwise.
+ * Return: 2, the status of a syntax error
  */
-int split_command_line_on_pipe(char *input, char ***commands, int *num_commands)
+static int parseError(token_t *tok)
 {
-	char *token;
-	int count = 0;
-	char *input_copy;
+	if (tok->type == TOK_EOF)
+		fprintf(stderr, "%s: 1: Syntax error: end of file unexpected\n",
+				shellName());
+	else
+		fprintf(stderr, "%s: 1: Syntax error: \"%s\" unexpected\n",
+				shellName(), tok->text);
+	return (2);
+}
 
-	/* Count the number of pipes */
-	for (int i = 0; input[i] != '\0'; i++)
+/**
+ * parseFd - converts the digits of an IO_NUMBER
+ * @digits: the IO_NUMBER's text
+ *
+ * Return: the descriptor, INT_MAX if it is too large to be one; the
+ * redirection then fails with EBADF when applied
+ */
+static int parseFd(const char *digits)
+{
+	int fd = 0;
+
+	for (; *digits != '\0'; digits++)
 	{
-		if (input[i] == '|')
+		if (fd > (INT_MAX - 9) / 10)
+			return (INT_MAX);
+		fd = fd * 10 + (*digits - '0');
+	}
+	return (fd);
+}
+
+/**
+ * parseCommand - parses a simple command: words and redirections
+ * @tokens: token stream from lexLine(), ended by TOK_EOF
+ * @pos: index of the command's first token, moved past it
+ * @out: set to the new command
+ *
+ * Description: argv gets one slot per word and the NULL, not zeroed
+ * arena memory; builtins must test each argument against NULL in order.
+ *
+ * Return: 0 on success, 2 on a syntax error, -1 on malloc failure
+ */
+static int parseCommand(token_t *tokens, int *pos, cmd_t **out)
+{
+	int i, words = 0, redirs = 0;
+	redir_t **link, *r;
+	cmd_t *cmd;
+
+	for (i = *pos; tokens[i].type != TOK_EOF; i++) /* size the argv first */
+	{
+		if (tokens[i].type == TOK_WORD)
+			words++;
+		else if (tokens[i].type == TOK_IO_NUMBER) /* a redirection follows */
+			continue;
+		else if (TOK_BIT(tokens[i].type) & TOK_REDIRECTS)
 		{
-			count++;
+			if (tokens[i + 1].type != TOK_WORD && /* needs a target, */
+				tokens[i + 1].type != TOK_IO_NUMBER) /* 1 in 2>&1>f is one */
+				return (parseError(&tokens[i + 1]));
+			redirs++;
+			i++;
 		}
+		else
+			break;
 	}
+	if (words == 0 && redirs == 0)
+		return (parseError(&tokens[i]));
 
-	/* Allocate memory for commands array + NULL terminator */
-	*commands = malloc(sizeof(char *) * (count + 2));
-	if (*commands == NULL)
+	cmd = arenaAlloc(sizeof(cmd_t));
+	if (cmd == NULL)
+		return (-1);
+	*out = cmd;
+	cmd->argv = arenaAlloc(sizeof(char *) * (words + 1));
+	if (cmd->argv == NULL)
+		return (-1);
+	link = &cmd->redirs;
+	for (words = 0; *pos < i; (*pos)++)
 	{
-		perror("malloc");
-		return -1;
+		if (tokens[*pos].type == TOK_WORD)
+		{
+			cmd->argv[words++] = tokens[*pos].text;
+			continue;
+		}
+		r = arenaAlloc(sizeof(redir_t));
+		if (r == NULL)
+			return (-1);
+		*link = r;
+		r->fd = -1;
+		r->body_fd = -1;
+		if (tokens[*pos].type == TOK_IO_NUMBER)
+			r->fd = parseFd(tokens[(*pos)++].text);
+		r->op = tokens[*pos].type;
+		if (r->fd == -1) /* <, << and <& change stdin, the others stdout */
+			r->fd = r->op == TOK_LESS || r->op == TOK_DLESS ||
+					r->op == TOK_LESSAND ? STDIN_FILENO : STDOUT_FILENO;
+		r->target = tokens[++(*pos)].text;
+		link = &r->next;
 	}
+	cmd->argv[words] = NULL;
+	return (0);
+}
+
+/**
+ * parsePipeline - parses commands separated by '|'
+ * @tokens: token stream from lexLine(), ended by TOK_EOF
+ * @pos: index of the pipeline's first token, moved past it
+ * @p: pipeline to fill
+ *
+ * Return: 0 on success, 2 on a syntax error, -1 on malloc failure
+ */
+static int parsePipeline(token_t *tokens, int *pos, pipeline_t *p)
+{
+	cmd_t **link = &p->cmds;
+	int rtn;
 
-	input_copy = _strdup(input); /* Duplicate the input string */
-	if (input_copy == NULL)
+	while (1)
 	{
-		perror("_strdup");
-		free(*commands);
-		return -1;
+		rtn = parseCommand(tokens, pos, link);
+		if (rtn != 0)
+			return (rtn);
+		p->ncmds++;
+		link = &(*link)->next;
+		if (tokens[*pos].type != TOK_PIPE)
+			return (0);
+		(*pos)++;
 	}
-	token = strtok(input_copy, "|"); /* Tokenize based on pipe*/
+}
 
-	int i = 0;
-	while (token != NULL)
+/**
+ * heredocFlush - writes the gathered body bytes to the body's memfd,
+ * creating it the first time
+ * @fd: the memfd, -1 if there is none yet
+ * @data: bytes to write
+ * @len: number of bytes
+ *
+ * Return: the memfd, -1 with errno set on failure
+ */
+static int heredocFlush(int fd, const char *data, size_t len)
+{
+	ssize_t n;
+
+	if (fd == -1)
+		fd = fdReserve(memfd_create("hsh-heredoc", MFD_CLOEXEC));
+	for (; fd != -1 && len > 0; data += n, len -= n)
 	{
-		(*commands)[i] = _strdup(token); /* Duplicate and store each token */
-		if ((*commands)[i] == NULL)
+		n = write(fd, data, len);
+		if (n == -1 && errno != EINTR)
 		{
-			perror("_strdup");
-			/* Free previously allocated memory before returning */
-			for (int j = 0; j < i; j++)
-			{
-				free((*commands)[j]);
-			}
-			free(*commands);
-			free(input_copy);
-			return -1;
+			n = errno;
+			close(fd);
+			errno = n;
+			return (-1);
 		}
-		i++;
-		token = strtok(NULL, "|"); /* get next command */
+		if (n == -1)
+			n = 0;
 	}
-
-	(*commands)[i] = NULL; /* Null-terminate array */
-	*num_commands = i;	   /* sets number of commands */
-	free(input_copy);
-	return 0; /* success */
+	return (fd);
 }
 
 /**
- * parse_command - Parses a command string into an array of arguments.
- * @command: The command string.
+ * heredocFinish - hands the body over as a descriptor to read it from
+ * @fd: memfd holding the body so far, -1 if all of it is in heredoc_buf
+ * @used: bytes still in heredoc_buf
+ *
+ * Description: a body no longer than PIPE_BUF goes into a pipe, which
+ * always has room for it; anything bigger goes into a memfd, rewound
+ * so the command reads it from the start. Neither touches a file system.
  *
- * Return: A NULL-terminated array of strings (arguments) or NULL on error.
+ * Return: the descriptor, close-on-exec and at or above SHELL_FD_MIN;
+ * -1 with errno set on failure
  */
-char **parse_command(char *command)
+static int heredocFinish(int fd, size_t used)
 {
-	int bufsize = 64, position = 0, i;
-	char **tokens = malloc(bufsize * sizeof(char *));
-	char *token;
+	int ends[2];
 
-	for (i = 0; i < bufsize; i++)
-		tokens[i] = NULL;
-	if (!tokens)
+	if (fd == -1 && used <= PIPE_BUF)
 	{
-		fprintf(stderr, "hsh: allocation error\n");
-		exit(EXIT_FAILURE);
+		if (pipe2(ends, O_CLOEXEC) == -1)
+			return (-1);
+		if (used > 0 && write(ends[1], heredoc_buf, used) == -1)
+		{
+			close(ends[0]);
+			ends[0] = -1;
+		}
+		close(ends[1]);
+		return (fdReserve(ends[0]));
 	}
+	fd = heredocFlush(fd, heredoc_buf, used);
+	if (fd != -1 && lseek(fd, 0, SEEK_SET) == -1)
+	{
+		close(fd);
+		return (-1);
+	}
+	return (fd);
+}
 
-	token = strtok(command, " \t\r\n\a");
-	while (token != NULL)
+/**
+ * parseHeredoc - streams a here document's body from the shell's input
+ * into a pipe or memfd
+ * @r: TOK_DLESS redirection, its target is the delimiter
+ *
+ * Description: the body is gathered in HEREDOC_CHUNK pieces and written
+ * out, so it can be any size. On a write error the rest of the body is
+ * still read, the line after it must not run as a command.
+ *
+ * Return: 0 on success, -1 after reporting the error
+ */
+static int parseHeredoc(redir_t *r)
+{
+	size_t len, used = 0;
+	int fd = -1, err = 0;
+	char *line;
+
+	if (inputIsTerminal())
 	{
-		tokens[position] = token;
-		position++;
+		printf("Enter input (end with %s):\n", r->target);
+		fflush(stdout);
+	}
 
-		if (position >= bufsize)
+	/* body comes from the shell's own input, not a second stdin reader */
+	while ((line = inputReadContinuation()) != NULL)
+	{
+		if (_strcmp(line, r->target) == 0)
+			break;
+		if (err)
+			continue;
+		len = _strlen(line);
+		line[len] = '\n'; /* was the newline, the line is not used again */
+		if (used + len + 1 > HEREDOC_CHUNK)
 		{
-			bufsize += 64;
-			tokens = realloc(tokens, bufsize * sizeof(char *));
-			if (!tokens)
+			fd = heredocFlush(fd, heredoc_buf, used);
+			used = 0;
+			if (fd != -1 && len + 1 > HEREDOC_CHUNK) /* a huge line */
+				fd = heredocFlush(fd, line, len + 1);
+			if (fd == -1)
 			{
-				fprintf(stderr, "hsh: allocation error\n");
-				exit(EXIT_FAILURE);
+				err = errno;
+				continue;
 			}
+			if (len + 1 > HEREDOC_CHUNK)
+				continue;
 		}
+		memcpy(heredoc_buf + used, line, len + 1);
+		used += len + 1;
+	}
+	if (!err)
+	{
+		r->body_fd = heredocFinish(fd, used);
+		if (r->body_fd == -1)
+			err = errno;
+	}
+	if (err)
+	{
+		fprintf(stderr, "%s: 1: here document: %s\n", shellName(),
+				strerror(err));
+		return (-1);
+	}
+	return (0);
+}
+
+/**
+ * parseHeredocs - reads the bodies of every here document of a line,
+ * in the order their operators appear, once the whole line is parsed
+ * @list: parsed line
+ *
+ * Return: 0 on success, -1 after reporting the error
+ */
+static int parseHeredocs(pipeline_t *list)
+{
+	pipeline_t *p;
+	cmd_t *cmd;
+	redir_t *r;
+
+	for (p = list; p != NULL; p = p->next)
+		for (cmd = p->cmds; cmd != NULL; cmd = cmd->next)
+			for (r = cmd->redirs; r != NULL; r = r->next)
+				if (r->op == TOK_DLESS && parseHeredoc(r) == -1)
+					return (-1);
+	return (0);
+}
 
-		token = strtok(NULL, " \t\r\n\a");
+/**
+ * parseLine - builds the syntax tree of a command line
+ * @tokens: token stream from lexLine(), ended by TOK_EOF
+ * @count: number of tokens
+ * @list: set to the list of pipelines, NULL for an empty line
+ *
+ * Description: list: pipeline { (&& | || | ;) pipeline } [;]
+ * pipeline: command { | command }, command: { WORD | redirection },
+ * redirection: [IO_NUMBER] (< | > | >> | << | <& | >&) WORD.
+ * Words are not copied, the tree points into the line; everything else
+ * comes from the line arena, released by arenaReset() once it has run.
+ *
+ * Return: 0 on success, 2 on a syntax error, -1 on malloc failure
+ */
+int parseLine(token_t *tokens, int count, pipeline_t **list)
+{
+	token_type_t connector = TOK_SEMI;
+	pipeline_t **link = list;
+	int pos = 0, rtn = 0;
+
+	*list = NULL;
+	while (pos < count)
+	{
+		*link = arenaAlloc(sizeof(pipeline_t));
+		if (*link == NULL)
+		{
+			rtn = -1;
+			break;
+		}
+		(*link)->connector = connector;
+		rtn = parsePipeline(tokens, &pos, *link);
+		if (rtn != 0)
+			break;
+		link = &(*link)->next;
+		if (pos == count)
+			break;
+		connector = tokens[pos++].type; /* && || or ;, anything else ends */
+		if (!(TOK_BIT(connector) & TOK_LIST_OPS))
+		{
+			rtn = parseError(&tokens[pos - 1]);
+			break;
+		}
+		if (connector != TOK_SEMI && pos == count) /* "a &&" */
+		{
+			rtn = parseError(&tokens[pos]);
+			break;
+		}
 	}
-	tokens[position] = NULL;
-	
-	/* printf("%s\n", tokens[0]); */
-	return tokens;
+	if (rtn == -1)
+		fprintf(stderr, "%s: allocation error\n", shellName());
+	if (rtn == 0 && parseHeredocs(*list) == -1)
+	{
+		parseRelease(*list); /* the bodies read before the failing one */
+		rtn = -1;
+	}
+	if (rtn != 0)
+		*list = NULL; /* partial tree goes with the next arenaReset() */
+	return (rtn);
+}
+
+/**
+ * parseRelease - closes the here document bodies of a line that has run
+ * @list: the line's tree, before arenaReset() drops it
+ */
+void parseRelease(pipeline_t *list)
+{
+	cmd_t *cmd;
+	redir_t *r;
+
+	for (; list != NULL; list = list->next)
+		for (cmd = list->cmds; cmd != NULL; cmd = cmd->next)
+			for (r = cmd->redirs; r != NULL; r = r->next)
+				if (r->body_fd != -1)
+				{
+					close(r->body_fd);
+					r->body_fd = -1;
+				}
 }
 
 // /**
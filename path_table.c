@@ -0,0 +1,233 @@
+#include "main.h"
+
+static path_table_t path_table;
+
+/**
+ * getPathTable - returns the parsed PATH, parsing it only if PATH changed
+ *
+ * Description: all directories live in one allocation: the path_dir_t
+ * array followed by a copy of PATH whose ':' separators became '\0'.
+ * Empty PATH entries are skipped, order is preserved.
+ *
+ * Return: pointer to the table, its count is 0 if PATH is unset
+ */
+path_table_t *getPathTable(void)
+{
+	char *path, *strings;
+	size_t count = 1, len, i, start;
+
+	if (path_table.valid)
+		return (&path_table);
+
+	path = _getenv("PATH");
+	path_table.count = 0;
+	path_table.valid = 1;
+	path_table.dirs_fresh = 0;
+	if (path == NULL)
+		return (&path_table);
+
+	len = _strlen(path);
+	for (i = 0; i < len; i++) /* upper bound on number of directories */
+		if (path[i] == ':')
+			count++;
+
+	path_table.arena = malloc(count * sizeof(path_dir_t) + len + 1);
+	if (path_table.arena == NULL)
+	{
+		path_table.valid = 0; /* retry on next lookup */
+		return (&path_table);
+	}
+	path_table.dirs = (path_dir_t *)path_table.arena;
+	strings = path_table.arena + count * sizeof(path_dir_t);
+	_strcpy(strings, path);
+
+	for (i = 0, start = 0; i <= len; i++)
+	{
+		if (strings[i] != ':' && strings[i] != '\0')
+			continue;
+		strings[i] = '\0';
+		if (i > start)
+		{
+			path_table.dirs[path_table.count].directory = strings + start;
+			path_table.dirs[path_table.count].len = i - start;
+			path_table.dirs[path_table.count].fd = fdReserve(open(strings +
+				start, O_PATH | O_DIRECTORY | O_CLOEXEC)); /* names resolve here */
+			path_table.dirs[path_table.count].mtime.tv_sec = -1;
+			path_table.dirs[path_table.count].mtime.tv_nsec = 0;
+			path_table.count++;
+		}
+		start = i + 1;
+	}
+	pathWatchStart(&path_table);
+	return (&path_table);
+}
+
+/**
+ * buildCandidate - writes "dir/name" into a caller supplied buffer
+ * @dir: PATH directory entry
+ * @name: command name
+ * @name_len: length of name
+ * @buf: buffer of at least PATH_MAX bytes
+ *
+ * Return: buf, or NULL if the result would not fit
+ */
+char *buildCandidate(const path_dir_t *dir, const char *name, size_t name_len,
+					 char *buf)
+{
+	if (dir->len + name_len + 2 > PATH_MAX)
+		return (NULL);
+	memcpy(buf, dir->directory, dir->len);
+	buf[dir->len] = '/';
+	memcpy(buf + dir->len + 1, name, name_len + 1);
+	return (buf);
+}
+
+/**
+ * pathDirHasCommand - checks for an executable file in a PATH directory
+ * @dir: PATH directory entry
+ * @name: command name, must not contain '/'
+ *
+ * Description: resolves name relative to the directory's O_PATH handle,
+ * so the directory path itself is never walked again.
+ *
+ * Return: 1 if dir holds a regular file called name with an execute bit,
+ * 0 otherwise
+ */
+int pathDirHasCommand(const path_dir_t *dir, const char *name)
+{
+	struct stat cmd_stat;
+
+	if (dir->fd < 0)
+		return (0);
+	if (fstatat(dir->fd, name, &cmd_stat, 0) != 0)
+		return (0);
+	return (S_ISREG(cmd_stat.st_mode) && (cmd_stat.st_mode & 0111));
+}
+
+/**
+ * pathExec - replaces the process with commandPath, launching through the
+ * same directory handle findPath() resolved it with when it came from PATH
+ * @commandPath: full path returned by findPath()
+ * @arguments: argv for the command
+ * @envp: environment for the command
+ *
+ * Return: only returns on failure, -1 with errno set
+ */
+int pathExec(const char *commandPath, char **arguments, char **envp)
+{
+	const char *base;
+	path_table_t *table = getPathTable();
+	size_t i, dir_len;
+
+	for (base = commandPath + _strlen(commandPath); base > commandPath; base--)
+		if (base[-1] == '/')
+			break;
+	dir_len = base > commandPath ? (size_t)(base - commandPath - 1) : 0;
+
+	for (i = 0; i < table->count && dir_len > 0; i++)
+	{
+		if (table->dirs[i].fd >= 0 && table->dirs[i].len == dir_len &&
+			memcmp(table->dirs[i].directory, commandPath, dir_len) == 0)
+		{
+			execveat(table->dirs[i].fd, base, arguments, envp, 0);
+			/* #! scripts cannot be found through a close-on-exec dirfd; */
+			/* EBADF/ENOTDIR: the handle is no longer the directory */
+			if (errno != ENOENT && errno != EBADF && errno != ENOTDIR)
+				return (-1);
+			break;
+		}
+	}
+	return (execve(commandPath, arguments, envp));
+}
+
+/**
+ * pathChanged - drops the parsed PATH and every remembered command;
+ * called by _setenv/_unsetenv whenever PATH is touched
+ */
+void pathChanged(void)
+{
+	destroyPathTable();
+	path_table.generation++;
+	hashClear();
+	missClear();
+}
+
+/**
+ * pathDirsEpoch - returns a counter that changes whenever a PATH
+ * directory's mtime changes, i.e. whenever a binary may have appeared
+ *
+ * Description: directories with an inotify watch are never stat'ed. The
+ * others are only stat'ed again after pathDirsStale(), which the shell
+ * calls once per command line, so a script that misses the same name on
+ * every line pays one fstat() per unwatched directory per line at most,
+ * and misses within a line cost no syscalls at all.
+ *
+ * Return: current epoch
+ */
+unsigned long pathDirsEpoch(void)
+{
+	path_table_t *table = getPathTable();
+	struct stat dir_stat;
+	path_dir_t *dir;
+	size_t i;
+	int changed = 0;
+
+	if (table->dirs_fresh)
+		return (table->dir_epoch);
+
+	for (i = 0; i < table->count; i++)
+	{
+		dir = &table->dirs[i];
+		if (dir->wd >= 0) /* watched, pathWatchDrain() evicts precisely */
+			continue;
+		if (dir->fd < 0) /* did not exist at parse time, maybe now */
+		{
+			dir->fd = fdReserve(open(dir->directory,
+									 O_PATH | O_DIRECTORY | O_CLOEXEC));
+			pathWatchDir(table, dir);
+		}
+		if (dir->fd < 0 || fstat(dir->fd, &dir_stat) != 0)
+		{
+			dir_stat.st_mtim.tv_sec = -1; /* missing dir, may appear later */
+			dir_stat.st_mtim.tv_nsec = 0;
+		}
+		if (dir_stat.st_mtim.tv_sec != dir->mtime.tv_sec ||
+			dir_stat.st_mtim.tv_nsec != dir->mtime.tv_nsec)
+		{
+			dir->mtime = dir_stat.st_mtim;
+			changed = 1;
+		}
+	}
+	if (changed)
+		table->dir_epoch++;
+	table->dirs_fresh = 1;
+	return (table->dir_epoch);
+}
+
+/**
+ * pathDirsStale - makes the next pathDirsEpoch() look at the directories
+ */
+void pathDirsStale(void)
+{
+	path_table.dirs_fresh = 0;
+	pathWatchDrain();
+}
+
+/**
+ * destroyPathTable - frees the parsed PATH
+ */
+void destroyPathTable(void)
+{
+	size_t i;
+
+	for (i = 0; i < path_table.count; i++)
+		if (path_table.dirs[i].fd >= 0)
+			close(path_table.dirs[i].fd);
+	if (path_table.arena != NULL && path_table.watch_fd >= 0)
+		close(path_table.watch_fd); /* drops every watch at once */
+	free(path_table.arena);
+	path_table.arena = NULL;
+	path_table.dirs = NULL;
+	path_table.count = 0;
+	path_table.valid = 0;
+}
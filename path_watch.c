@@ -0,0 +1,123 @@
+#include "main.h"
+#include <sys/inotify.h>
+
+#define PATH_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | \
+						 IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+static int path_watch_enabled = 1;
+
+/**
+ * pathWatchDisable - never set up watches, every directory is polled
+ *
+ * Description: for short runs like -c, where the inotify setup costs more
+ * syscalls than the few lookups it would save.
+ */
+void pathWatchDisable(void)
+{
+	path_watch_enabled = 0;
+}
+
+/**
+ * pathWatchStart - sets up an inotify watch on every PATH directory
+ * @table: freshly parsed PATH table
+ *
+ * Description: optional, if inotify is unavailable or a watch cannot be
+ * added (e.g. max_user_watches reached) that directory simply falls back
+ * to mtime polling in pathDirsEpoch().
+ */
+void pathWatchStart(path_table_t *table)
+{
+	size_t i;
+
+	table->watch_fd = -1;
+	if (path_watch_enabled)
+		table->watch_fd = fdReserve(inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+	for (i = 0; i < table->count; i++)
+	{
+		table->dirs[i].wd = -1;
+		pathWatchDir(table, &table->dirs[i]);
+	}
+}
+
+/**
+ * pathWatchDir - adds the inotify watch for one PATH directory
+ * @table: PATH table owning the inotify descriptor
+ * @dir: directory to watch, its wd is -1 on failure
+ */
+void pathWatchDir(path_table_t *table, path_dir_t *dir)
+{
+	if (table->watch_fd < 0 || dir->fd < 0)
+		return;
+	dir->wd = inotify_add_watch(table->watch_fd, dir->directory,
+								PATH_WATCH_MASK);
+}
+
+/**
+ * pathWatchLost - a watched directory itself went away or moved; go back
+ * to polling it and forget everything, any command may resolve elsewhere
+ * @table: PATH table
+ * @wd: watch descriptor from the event
+ */
+static void pathWatchLost(path_table_t *table, int wd)
+{
+	size_t i;
+	int lost = 0;
+
+	for (i = 0; i < table->count; i++) /* same dir may be listed twice */
+	{
+		if (table->dirs[i].wd != wd)
+			continue;
+		table->dirs[i].wd = -1;
+		if (table->dirs[i].fd >= 0)
+			close(table->dirs[i].fd);
+		table->dirs[i].fd = -1; /* reopened by pathDirsEpoch() */
+		table->dirs[i].mtime.tv_sec = -1;
+		lost = 1;
+	}
+	if (!lost)
+		return;
+	inotify_rm_watch(table->watch_fd, wd);
+	table->dirs_fresh = 0;
+	hashClear();
+	missClear();
+}
+
+/**
+ * pathWatchDrain - applies pending PATH directory events without blocking
+ *
+ * Description: a binary created, removed, renamed or chmod'ed in a PATH
+ * directory evicts exactly that name from the hash and the negative
+ * cache; other entries stay valid.
+ */
+void pathWatchDrain(void)
+{
+	path_table_t *table = getPathTable();
+	char buf[4096]
+		__attribute__((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event *event;
+	ssize_t n;
+	char *p;
+
+	if (table->arena == NULL || table->watch_fd < 0)
+		return;
+
+	while ((n = read(table->watch_fd, buf, sizeof(buf))) > 0)
+	{
+		for (p = buf; p < buf + n; p += sizeof(*event) + event->len)
+		{
+			event = (const struct inotify_event *)p;
+			if (event->mask & IN_Q_OVERFLOW) /* events lost, trust nothing */
+			{
+				hashClear();
+				missClear();
+			}
+			else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+				pathWatchLost(table, event->wd);
+			else if (event->len > 0)
+			{
+				hashRemove(event->name);
+				missRemove(event->name);
+			}
+		}
+	}
+}
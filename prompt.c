@@ -0,0 +1,204 @@
+#include "main.h"
+
+/* "[Go$H] | user@hostname:path$ " */
+#define PROMPT_DEFAULT CLR_YELLOW_BOLD "[" CLR_RED_BOLD "Go$H" CLR_YELLOW_BOLD \
+	"]" CLR_DEFAULT " | " CLR_GREEN_BOLD "\\u@\\h" CLR_DEFAULT_BOLD ":"     \
+	CLR_BLUE_BOLD "\\w" CLR_DEFAULT "\\$ "
+
+static prompt_t prompt;
+
+/**
+ * promptCompile - turns the PS1 format (or the default) into segments
+ *
+ * Description: supports \u (user), \h (hostname), \w (working directory),
+ * \$ ('$'), \e (escape), \n (newline) and \\. Literal text is resolved
+ * into prompt.text and referenced by the segments.
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+static int promptCompile(void)
+{
+	const char *fmt = _getenv("PS1");
+	size_t len, i, out = 0;
+	prompt_seg_t *seg;
+	char c;
+
+	if (fmt == NULL)
+		fmt = PROMPT_DEFAULT;
+	len = _strlen(fmt);
+	prompt.text = malloc(len + 1);
+	prompt.segs = malloc(sizeof(prompt_seg_t) * (len + 1));
+	if (prompt.text == NULL || prompt.segs == NULL)
+	{
+		free(prompt.text);
+		free(prompt.segs);
+		prompt.text = NULL;
+		prompt.segs = NULL;
+		return (-1);
+	}
+
+	prompt.nsegs = 0;
+	for (i = 0; i < len; i++)
+	{
+		c = fmt[i];
+		if (c == '\\' && (fmt[i + 1] == 'u' || fmt[i + 1] == 'h' ||
+						  fmt[i + 1] == 'w'))
+		{
+			i++;
+			seg = &prompt.segs[prompt.nsegs++];
+			seg->type = fmt[i] == 'u' ? PS_USER : fmt[i] == 'h' ? PS_HOST : PS_CWD;
+			continue;
+		}
+		if (c == '\\' && fmt[i + 1] != '\0') /* escaped literal */
+		{
+			i++;
+			c = fmt[i] == 'e' ? '\033' : fmt[i] == 'n' ? '\n' : fmt[i];
+		}
+		if (prompt.nsegs == 0 || prompt.segs[prompt.nsegs - 1].type != PS_TEXT)
+		{ /* start a new run of literal text */
+			seg = &prompt.segs[prompt.nsegs++];
+			seg->type = PS_TEXT;
+			seg->text = prompt.text + out;
+			seg->len = 0;
+		}
+		prompt.text[out++] = c;
+		prompt.segs[prompt.nsegs - 1].len++;
+	}
+	return (0);
+}
+
+/**
+ * promptAppend - appends bytes to the rendered prompt
+ * @s: bytes
+ * @len: number of bytes
+ *
+ * Return: 0 on success, -1 on malloc failure
+ */
+static int promptAppend(const char *s, size_t len)
+{
+	char *grown;
+	size_t cap = prompt.cap ? prompt.cap : 128;
+
+	while (prompt.len + len > cap)
+		cap *= 2;
+	if (cap != prompt.cap)
+	{
+		grown = realloc(prompt.rendered, cap);
+		if (grown == NULL)
+			return (-1);
+		prompt.rendered = grown;
+		prompt.cap = cap;
+	}
+	memcpy(prompt.rendered + prompt.len, s, len);
+	prompt.len += len;
+	return (0);
+}
+
+/**
+ * promptRender - rebuilds whatever part of the prompt was invalidated
+ *
+ * Return: 0 on success, -1 on failure
+ */
+static int promptRender(void)
+{
+	size_t i;
+	const char *s;
+
+	if (prompt.segs == NULL && promptCompile() == -1)
+		return (-1);
+	if (prompt.user == NULL)
+		prompt.user = getUser();
+	if (prompt.host == NULL)
+		prompt.host = getHostname();
+	if (!prompt.cwd_valid)
+	{
+		if (getcwd(prompt.cwd, sizeof(prompt.cwd)) == NULL)
+			prompt.cwd[0] = '\0';
+		prompt.cwd_valid = 1;
+	}
+
+	prompt.len = 0;
+	for (i = 0; i < prompt.nsegs; i++)
+	{
+		if (prompt.segs[i].type == PS_TEXT)
+		{
+			if (promptAppend(prompt.segs[i].text, prompt.segs[i].len) == -1)
+				return (-1);
+			continue;
+		}
+		s = prompt.segs[i].type == PS_USER ? prompt.user
+		  : prompt.segs[i].type == PS_HOST ? prompt.host : prompt.cwd;
+		if (s != NULL && promptAppend(s, _strlen(s)) == -1)
+			return (-1);
+	}
+	prompt.valid = 1;
+	return (0);
+}
+
+/**
+ * printPrompt - prints the prompt ("[Go$H] | user@hostname:path$ " unless
+ * PS1 says otherwise) with a single write()
+ *
+ * Description: only called in interactive mode. The rendered prompt is
+ * reused until cd or setenv/unsetenv invalidate part of it.
+ */
+void printPrompt(void)
+{
+	if (!prompt.valid && promptRender() == -1)
+		return;
+	fflush(stdout); /* anything printf'd by the last command goes first */
+	if (write(STDOUT_FILENO, prompt.rendered, prompt.len) == -1)
+		perror("write");
+}
+
+/**
+ * promptEnvChanged - invalidates what depends on a variable that changed
+ * @name: name of the variable set or unset
+ */
+void promptEnvChanged(const char *name)
+{
+	if (_strcmp(name, "PS1") == 0)
+	{
+		free(prompt.segs);
+		free(prompt.text);
+		prompt.segs = NULL;
+		prompt.text = NULL;
+	}
+	else if (_strcmp(name, "USER") == 0 || _strcmp(name, "LOGNAME") == 0)
+	{
+		free(prompt.user);
+		prompt.user = NULL;
+	}
+	else if (_strcmp(name, "NAME") == 0 || _strcmp(name, "HOSTNAME") == 0 ||
+			 _strcmp(name, "WSL_DISTRO_NAME") == 0)
+	{
+		free(prompt.host);
+		prompt.host = NULL;
+	}
+	else if (_strcmp(name, "PWD") == 0) /* cd sets it after chdir() */
+		prompt.cwd_valid = 0;
+	else
+		return;
+	prompt.valid = 0;
+}
+
+/**
+ * promptDestroy - frees the compiled and rendered prompt
+ */
+void promptDestroy(void)
+{
+	free(prompt.segs);
+	free(prompt.text);
+	free(prompt.user);
+	free(prompt.host);
+	free(prompt.rendered);
+	prompt.segs = NULL;
+	prompt.text = NULL;
+	prompt.user = NULL;
+	prompt.host = NULL;
+	prompt.rendered = NULL;
+	prompt.len = 0;
+	prompt.cap = 0;
+	prompt.valid = 0;
+	prompt.cwd_valid = 0;
+}
@@ -0,0 +1,246 @@
+#include "main.h"
+
+/**
+ * fdReserve - moves a descriptor the shell keeps for itself to
+ * SHELL_FD_MIN or above, where no redirection can reach it
+ * @fd: close-on-exec descriptor, -1 is passed through
+ *
+ * Return: the new descriptor, close-on-exec; -1 with errno set on
+ * failure, fd is closed either way
+ */
+int fdReserve(int fd)
+{
+	int high, err;
+
+	if (fd == -1 || fd >= SHELL_FD_MIN)
+		return (fd);
+	high = fcntl(fd, F_DUPFD_CLOEXEC, SHELL_FD_MIN);
+	err = errno;
+	close(fd);
+	errno = err;
+	return (high);
+}
+
+/**
+ * redirOpen - opens the file a redirection points at
+ * @r: redirection, <, > or >>
+ *
+ * Return: the open descriptor, -1 with errno set on failure
+ */
+static int redirOpen(redir_t *r)
+{
+	switch (r->op)
+	{
+	case TOK_GREAT:
+		return (open(r->target, O_WRONLY | O_CREAT | O_TRUNC, 0644));
+	case TOK_DGREAT:
+		return (open(r->target, O_WRONLY | O_CREAT | O_APPEND, 0644));
+	default: /* TOK_LESS */
+		return (open(r->target, O_RDONLY));
+	}
+}
+
+/**
+ * redirHeredoc - makes r->fd read the here document's body
+ * @r: TOK_DLESS redirection
+ *
+ * Description: the parser left the body in a close-on-exec pipe or
+ * memfd, positioned at its start; there is nothing to open.
+ *
+ * Return: 0 on success, -1 with errno set on failure
+ */
+static int redirHeredoc(redir_t *r)
+{
+	if (r->body_fd == r->fd) /* dup2 would keep close-on-exec set */
+		return (fcntl(r->fd, F_SETFD, 0));
+	return (dup2(r->body_fd, r->fd) == -1 ? -1 : 0);
+}
+
+/**
+ * redirCopy - applies <& or >&: makes r->fd a copy of the descriptor
+ * named by the target, or closes it for "-"
+ * @r: redirection
+ *
+ * Return: 0 on success, -1 with errno set on failure
+ */
+static int redirCopy(redir_t *r)
+{
+	const char *p = r->target;
+	int from = 0, flags;
+
+	if (p[0] == '-' && p[1] == '\0')
+	{
+		close(r->fd); /* closing one that is not open is no error */
+		return (0);
+	}
+	for (; *p >= '0' && *p <= '9' && from < 1 << 20; p++)
+		from = from * 10 + (*p - '0');
+	if (*p != '\0' || p == r->target)
+	{
+		errno = EBADF; /* not a descriptor number */
+		return (-1);
+	}
+	flags = fcntl(from, F_GETFD);
+	if (flags == -1 || flags & FD_CLOEXEC)
+	{
+		errno = EBADF; /* close-on-exec ones are the shell's own */
+		return (-1);
+	}
+	if (from == r->fd) /* 1>&1 only checks that 1 is open */
+		return (0);
+	return (dup2(from, r->fd) == -1 ? -1 : 0);
+}
+
+/**
+ * redirError - reports a redirection that could not be applied
+ * @r: redirection
+ * @err: errno of the failure
+ */
+void redirError(redir_t *r, int err)
+{
+	if (r->fd >= SHELL_FD_MIN && r->fd != INT_MAX)
+		fprintf(stderr, "%s: 1: %d: %s\n", shellName(), r->fd,
+				strerror(err));
+	else if (r->op == TOK_LESSAND || r->op == TOK_GREATAND)
+		fprintf(stderr, "%s: 1: %s: %s\n", shellName(),
+				r->target, strerror(err));
+	else if (r->op == TOK_DLESS)
+		fprintf(stderr, "%s: 1: here document: %s\n", shellName(),
+				strerror(err));
+	else
+		fprintf(stderr, "%s: 1: cannot %s %s: %s\n", shellName(),
+				r->op == TOK_GREAT || r->op == TOK_DGREAT ? "create" : "open",
+				r->target, strerror(err));
+}
+
+/**
+ * redirApply - applies a command's redirections to the current process,
+ * left to right, so "2>&1 >f" and ">f 2>&1" differ like in sh
+ * @redirs: redirections, may be NULL
+ * @saved: NULL in a child about to exec; in the shell itself, each
+ * descriptor is saved here before it changes, for redirRestore()
+ * @failed: set to the index of the failing redirection
+ *
+ * Description: prints nothing, a launched child shares the shell's
+ * memory until it execs; the launch layer hands the error to the parent.
+ *
+ * Return: 0 on success, -1 with errno set on failure
+ */
+int redirApply(redir_t *redirs, redir_save_t **saved, int *failed)
+{
+	int fd, err;
+
+	for (*failed = 0; redirs != NULL; redirs = redirs->next, (*failed)++)
+	{
+		if (redirs->fd >= SHELL_FD_MIN) /* the shell's own descriptors */
+		{
+			errno = EBADF;
+			return (-1);
+		}
+		if (saved != NULL && redirSave(redirs->fd, saved) == -1)
+			return (-1);
+		if (redirs->op == TOK_LESSAND || redirs->op == TOK_GREATAND)
+		{
+			if (redirCopy(redirs) == -1)
+				return (-1);
+			continue;
+		}
+		if (redirs->op == TOK_DLESS)
+		{
+			if (redirHeredoc(redirs) == -1)
+				return (-1);
+			continue;
+		}
+		fd = redirOpen(redirs);
+		if (fd == -1)
+			return (-1);
+		if (fd != redirs->fd)
+		{
+			if (dup2(fd, redirs->fd) == -1)
+			{
+				err = errno;
+				close(fd);
+				errno = err;
+				return (-1);
+			}
+			close(fd);
+		}
+	}
+	return (0);
+}
+
+/**
+ * redirSave - remembers what a descriptor of the shell refers to before
+ * it is changed for a builtin
+ * @fd: descriptor about to change
+ * @saved: list of saved descriptors, the copy is pushed on it
+ *
+ * Description: the copy goes to SHELL_FD_MIN or above and is
+ * close-on-exec, out of the way of the redirections; nodes come from the
+ * line arena.
+ *
+ * Return: 0 on success, -1 with errno set on failure
+ */
+int redirSave(int fd, redir_save_t **saved)
+{
+	redir_save_t *node = arenaAlloc(sizeof(redir_save_t));
+
+	if (node == NULL)
+	{
+		errno = ENOMEM;
+		return (-1);
+	}
+	node->fd = fd;
+	node->copy = fcntl(fd, F_DUPFD_CLOEXEC, SHELL_FD_MIN);
+	if (node->copy == -1 && errno != EBADF) /* EBADF: it was closed */
+		return (-1);
+	node->next = *saved;
+	*saved = node;
+	return (0);
+}
+
+/**
+ * redirRestore - puts back every descriptor redirSave() saved, newest
+ * first, so a descriptor changed twice ends up as it was at the start
+ * @saved: list of saved descriptors
+ */
+void redirRestore(redir_save_t *saved)
+{
+	for (; saved != NULL; saved = saved->next)
+	{
+		if (saved->copy == -1)
+			close(saved->fd);
+		else
+		{
+			dup2(saved->copy, saved->fd);
+			close(saved->copy);
+		}
+	}
+}
+
+/**
+ * redirTouch - performs the redirections of a command without words,
+ * e.g. "> file", which only creates or truncates the file
+ * @redirs: redirections
+ *
+ * Return: 0 on success, 2 after reporting the failing redirection
+ */
+int redirTouch(redir_t *redirs)
+{
+	int fd;
+
+	for (; redirs != NULL; redirs = redirs->next)
+	{
+		if (redirs->op == TOK_DLESS || redirs->op == TOK_LESSAND ||
+			redirs->op == TOK_GREATAND) /* nothing would use them */
+			continue;
+		fd = redirOpen(redirs);
+		if (fd == -1)
+		{
+			redirError(redirs, errno);
+			return (2);
+		}
+		close(fd);
+	}
+	return (0);
+}
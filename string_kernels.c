@@ -0,0 +1,739 @@
+#include "main.h"
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define STR_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * Scanning kernels behind _strlen, _strchr, _strcmp, _strcspn and _strstr.
+ *
+ * Every level reads whole aligned words or vectors. An aligned load never
+ * crosses a page boundary, so reading past the terminating NUL inside the
+ * same word is safe, the same trick the C library uses. The one unaligned
+ * stream (the second string of a compare) is checked for page crossings.
+ */
+
+#define SWAR_ONES ((uint64_t)0x0101010101010101ULL)
+#define SWAR_HIGHS (SWAR_ONES * 0x80)
+#define PAGE_SIZE_MIN 4096
+
+/**
+ * swarZero - flags the zero bytes of a word
+ * @v: eight bytes
+ *
+ * Return: nonzero if v has a zero byte (the lowest flag is exact)
+ */
+static inline uint64_t swarZero(uint64_t v)
+{
+	return ((v - SWAR_ONES) & ~v & SWAR_HIGHS);
+}
+
+/**
+ * swarLoad - loads eight bytes without breaking strict aliasing
+ * @p: address, aligned by the callers that must not cross a page
+ *
+ * Return: the bytes as one word
+ */
+static inline uint64_t swarLoad(const char *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return (v);
+}
+
+/**
+ * crossesPage - tells whether an n byte load at p may touch the next page
+ * @p: address of the load
+ * @n: size of the load
+ *
+ * Return: 1 if it may, 0 otherwise
+ */
+static inline int crossesPage(const char *p, size_t n)
+{
+	return (((uintptr_t)p & (PAGE_SIZE_MIN - 1)) > PAGE_SIZE_MIN - n);
+}
+
+/**
+ * cmpBlock - compares one n byte block a byte at a time, used where the
+ * unaligned load of b would cross into the next page
+ * @a: 1st string
+ * @b: 2nd string
+ * @n: block size
+ * @diff: set to the result when the strings end or differ in the block
+ *
+ * Return: 1 if diff was set, 0 if the block is equal and the strings go on
+ */
+static inline int cmpBlock(const char *a, const char *b, size_t n, int *diff)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+	{
+		if (a[i] == '\0' || a[i] != b[i])
+		{
+			*diff = a[i] - b[i];
+			return (1);
+		}
+	}
+	return (0);
+}
+
+/* ------------------------------ scalar ------------------------------ */
+
+/**
+ * lenScalar - strlen, one byte at a time
+ * @s: string
+ *
+ * Return: length of s
+ */
+static size_t lenScalar(const char *s)
+{
+	const char *p = s;
+
+	while (*p != '\0')
+		p++;
+	return (p - s);
+}
+
+/**
+ * chrScalar - finds c or the end of s, one byte at a time
+ * @s: string
+ * @c: byte to find
+ *
+ * Return: first byte of s equal to c, or its terminating NUL
+ */
+static const char *chrScalar(const char *s, int c)
+{
+	while (*s != '\0' && *s != (char)c)
+		s++;
+	return (s);
+}
+
+/**
+ * cmpScalar - strcmp, one byte at a time
+ * @a: 1st string
+ * @b: 2nd string
+ *
+ * Return: difference of the first differing chars, 0 if equal
+ */
+static int cmpScalar(const char *a, const char *b)
+{
+	while (*a != '\0' && *a == *b)
+	{
+		a++;
+		b++;
+	}
+	return (*a - *b);
+}
+
+/**
+ * cspnScalar - strcspn through a 256 entry table
+ * @s: string
+ * @reject: bytes that end the span
+ *
+ * Return: length of the leading part of s without any byte of reject
+ */
+static size_t cspnScalar(const char *s, const char *reject)
+{
+	unsigned char table[256] = {0};
+	const char *p;
+
+	table[0] = 1;
+	for (; *reject != '\0'; reject++)
+		table[(unsigned char)*reject] = 1;
+	for (p = s; !table[(unsigned char)*p]; p++)
+		;
+	return (p - s);
+}
+
+/**
+ * cspnHead - scalar strcspn over the first few bytes of s
+ * @s: string
+ * @reject: bytes that end the span
+ * @limit: bytes to look at
+ *
+ * Description: words on a command line are short, so most spans end
+ * before a vector kernel has paid for building its patterns.
+ *
+ * Return: the byte that ends the span, NULL if it is past limit
+ */
+static const char *cspnHead(const char *s, const char *reject, size_t limit)
+{
+	unsigned char table[256] = {0};
+
+	table[0] = 1;
+	for (; *reject != '\0'; reject++)
+		table[(unsigned char)*reject] = 1;
+	for (; limit > 0; limit--, s++)
+		if (table[(unsigned char)*s])
+			return (s);
+	return (NULL);
+}
+
+/* ------------------------------- SWAR ------------------------------- */
+
+/**
+ * lenSwar - strlen, eight bytes at a time
+ * @s: string
+ *
+ * Return: length of s
+ */
+static size_t lenSwar(const char *s)
+{
+	const char *p = s;
+
+	for (; (uintptr_t)p & 7; p++) /* up to the first aligned word */
+		if (*p == '\0')
+			return (p - s);
+	while (!swarZero(swarLoad(p)))
+		p += 8;
+	while (*p != '\0')
+		p++;
+	return (p - s);
+}
+
+/**
+ * chrSwar - finds c or the end of s, eight bytes at a time
+ * @s: string
+ * @c: byte to find
+ *
+ * Return: first byte of s equal to c, or its terminating NUL
+ */
+static const char *chrSwar(const char *s, int c)
+{
+	uint64_t pattern = SWAR_ONES * (unsigned char)c, v;
+
+	for (; (uintptr_t)s & 7; s++)
+		if (*s == '\0' || *s == (char)c)
+			return (s);
+	while (1)
+	{
+		v = swarLoad(s);
+		if (swarZero(v) | swarZero(v ^ pattern))
+			break;
+		s += 8;
+	}
+	return (chrScalar(s, c));
+}
+
+/**
+ * cmpSwar - strcmp, eight bytes at a time
+ * @a: 1st string
+ * @b: 2nd string
+ *
+ * Return: difference of the first differing chars, 0 if equal
+ */
+static int cmpSwar(const char *a, const char *b)
+{
+	uint64_t va;
+	int diff;
+
+	for (; (uintptr_t)a & 7; a++, b++)
+		if (*a == '\0' || *a != *b)
+			return (*a - *b);
+	for (;; a += 8, b += 8)
+	{
+		if (crossesPage(b, 8))
+		{
+			if (cmpBlock(a, b, 8, &diff))
+				return (diff);
+			continue;
+		}
+		va = swarLoad(a);
+		if (va != swarLoad(b) || swarZero(va))
+			return (cmpScalar(a, b));
+	}
+}
+
+/**
+ * cspnSwar - strcspn, eight bytes at a time for up to 8 reject bytes
+ * @s: string
+ * @reject: bytes that end the span
+ *
+ * Return: length of the leading part of s without any byte of reject
+ */
+static size_t cspnSwar(const char *s, const char *reject)
+{
+	uint64_t patterns[8], v, hit;
+	const char *p = cspnHead(s, reject, 8);
+	size_t n, i;
+
+	if (p != NULL)
+		return (p - s);
+	n = lenScalar(reject);
+	if (n > 8)
+		return (cspnScalar(s, reject));
+	p = s + 8;
+	for (i = 0; i < n; i++)
+		patterns[i] = SWAR_ONES * (unsigned char)reject[i];
+	for (; (uintptr_t)p & 7; p++)
+		if (*p == '\0' || chrScalar(reject, *p)[0] != '\0')
+			return (p - s);
+	while (1)
+	{
+		v = swarLoad(p);
+		hit = swarZero(v);
+		for (i = 0; i < n; i++)
+			hit |= swarZero(v ^ patterns[i]);
+		if (hit)
+			break;
+		p += 8;
+	}
+	return ((p - s) + cspnScalar(p, reject));
+}
+
+#ifdef STR_HAVE_X86
+/* ------------------------------- SSE2 ------------------------------- */
+
+/**
+ * lenSse2 - strlen, sixteen bytes at a time
+ * @s: string
+ *
+ * Return: length of s
+ */
+__attribute__((target("sse2"))) static size_t lenSse2(const char *s)
+{
+	const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)15);
+	__m128i zero = _mm_setzero_si128();
+	unsigned int mask;
+
+	mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)p),
+											zero));
+	mask >>= s - p; /* bytes before s do not count */
+	if (mask)
+		return (__builtin_ctz(mask));
+	while (1)
+	{
+		p += 16;
+		mask = _mm_movemask_epi8(
+			_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)p), zero));
+		if (mask)
+			return ((p - s) + __builtin_ctz(mask));
+	}
+}
+
+/**
+ * chrSse2 - finds c or the end of s, sixteen bytes at a time
+ * @s: string
+ * @c: byte to find
+ *
+ * Return: first byte of s equal to c, or its terminating NUL
+ */
+__attribute__((target("sse2"))) static const char *chrSse2(const char *s,
+														  int c)
+{
+	const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)15);
+	__m128i zero = _mm_setzero_si128(), want = _mm_set1_epi8((char)c), v;
+	unsigned int mask;
+
+	v = _mm_load_si128((const __m128i *)p);
+	mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, zero),
+										  _mm_cmpeq_epi8(v, want)));
+	mask >>= s - p;
+	if (mask)
+		return (s + __builtin_ctz(mask));
+	while (1)
+	{
+		p += 16;
+		v = _mm_load_si128((const __m128i *)p);
+		mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, zero),
+											  _mm_cmpeq_epi8(v, want)));
+		if (mask)
+			return (p + __builtin_ctz(mask));
+	}
+}
+
+/**
+ * cmpSse2 - strcmp, sixteen bytes at a time
+ * @a: 1st string
+ * @b: 2nd string
+ *
+ * Return: difference of the first differing chars, 0 if equal
+ */
+__attribute__((target("sse2"))) static int cmpSse2(const char *a,
+												  const char *b)
+{
+	__m128i zero = _mm_setzero_si128(), va, vb;
+	unsigned int mask;
+	int diff;
+
+	for (; (uintptr_t)a & 15; a++, b++)
+		if (*a == '\0' || *a != *b)
+			return (*a - *b);
+	for (;; a += 16, b += 16)
+	{
+		if (crossesPage(b, 16))
+		{
+			if (cmpBlock(a, b, 16, &diff))
+				return (diff);
+			continue;
+		}
+		va = _mm_load_si128((const __m128i *)a);
+		vb = _mm_loadu_si128((const __m128i *)b);
+		mask = (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) ^ 0xFFFF) |
+			   _mm_movemask_epi8(_mm_cmpeq_epi8(va, zero));
+		if (mask)
+		{
+			mask = __builtin_ctz(mask);
+			return (a[mask] - b[mask]);
+		}
+	}
+}
+
+/**
+ * cspnSse2 - strcspn, sixteen bytes at a time for up to 16 reject bytes
+ * @s: string
+ * @reject: bytes that end the span
+ *
+ * Return: length of the leading part of s without any byte of reject
+ */
+__attribute__((target("sse2"))) static size_t cspnSse2(const char *s,
+													  const char *reject)
+{
+	const char *p = cspnHead(s, reject, 16);
+	__m128i wanted[16], v, hit;
+	size_t n, i;
+	unsigned int mask;
+
+	if (p != NULL)
+		return (p - s);
+	n = lenScalar(reject);
+	if (n > 16)
+		return (cspnScalar(s, reject));
+	s += 16;
+	p = (const char *)((uintptr_t)s & ~(uintptr_t)15);
+	for (i = 0; i < n; i++)
+		wanted[i] = _mm_set1_epi8(reject[i]);
+	for (;; p += 16)
+	{
+		v = _mm_load_si128((const __m128i *)p);
+		hit = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+		for (i = 0; i < n; i++)
+			hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, wanted[i]));
+		mask = _mm_movemask_epi8(hit);
+		if (p < s)
+			mask >>= s - p; /* first block: bytes before s do not count */
+		if (mask)
+			return (16 + (p < s ? 0 : (size_t)(p - s)) + __builtin_ctz(mask));
+	}
+}
+
+/* ------------------------------- AVX2 ------------------------------- */
+
+/**
+ * lenAvx2 - strlen, thirty-two bytes at a time
+ * @s: string
+ *
+ * Return: length of s
+ */
+__attribute__((target("avx2"))) static size_t lenAvx2(const char *s)
+{
+	const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+	__m256i zero = _mm256_setzero_si256();
+	unsigned int mask;
+
+	mask = (unsigned int)_mm256_movemask_epi8(
+		_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), zero));
+	mask >>= s - p;
+	if (mask)
+		return (__builtin_ctz(mask));
+	while (1)
+	{
+		p += 32;
+		mask = (unsigned int)_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), zero));
+		if (mask)
+			return ((p - s) + __builtin_ctz(mask));
+	}
+}
+
+/**
+ * chrAvx2 - finds c or the end of s, thirty-two bytes at a time
+ * @s: string
+ * @c: byte to find
+ *
+ * Return: first byte of s equal to c, or its terminating NUL
+ */
+__attribute__((target("avx2"))) static const char *chrAvx2(const char *s,
+														  int c)
+{
+	const char *p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+	__m256i zero = _mm256_setzero_si256(), want = _mm256_set1_epi8((char)c);
+	__m256i v;
+	unsigned int mask;
+
+	v = _mm256_load_si256((const __m256i *)p);
+	mask = (unsigned int)_mm256_movemask_epi8(
+		_mm256_or_si256(_mm256_cmpeq_epi8(v, zero), _mm256_cmpeq_epi8(v, want)));
+	mask >>= s - p;
+	if (mask)
+		return (s + __builtin_ctz(mask));
+	while (1)
+	{
+		p += 32;
+		v = _mm256_load_si256((const __m256i *)p);
+		mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(
+			_mm256_cmpeq_epi8(v, zero), _mm256_cmpeq_epi8(v, want)));
+		if (mask)
+			return (p + __builtin_ctz(mask));
+	}
+}
+
+/**
+ * cmpAvx2 - strcmp, thirty-two bytes at a time
+ * @a: 1st string
+ * @b: 2nd string
+ *
+ * Return: difference of the first differing chars, 0 if equal
+ */
+__attribute__((target("avx2"))) static int cmpAvx2(const char *a,
+												  const char *b)
+{
+	__m256i zero = _mm256_setzero_si256(), va, vb;
+	unsigned int mask;
+	int diff;
+
+	for (; (uintptr_t)a & 31; a++, b++)
+		if (*a == '\0' || *a != *b)
+			return (*a - *b);
+	for (;; a += 32, b += 32)
+	{
+		if (crossesPage(b, 32))
+		{
+			if (cmpBlock(a, b, 32, &diff))
+				return (diff);
+			continue;
+		}
+		va = _mm256_load_si256((const __m256i *)a);
+		vb = _mm256_loadu_si256((const __m256i *)b);
+		mask = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)) |
+			   (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, zero));
+		if (mask)
+		{
+			mask = __builtin_ctz(mask);
+			return (a[mask] - b[mask]);
+		}
+	}
+}
+
+/**
+ * cspnAvx2 - strcspn, thirty-two bytes at a time for up to 16 reject bytes
+ * @s: string
+ * @reject: bytes that end the span
+ *
+ * Return: length of the leading part of s without any byte of reject
+ */
+__attribute__((target("avx2"))) static size_t cspnAvx2(const char *s,
+													  const char *reject)
+{
+	const char *p = cspnHead(s, reject, 32);
+	__m256i wanted[16], v, hit;
+	size_t n, i;
+	unsigned int mask;
+
+	if (p != NULL)
+		return (p - s);
+	n = lenScalar(reject);
+	if (n > 16)
+		return (cspnScalar(s, reject));
+	s += 32;
+	p = (const char *)((uintptr_t)s & ~(uintptr_t)31);
+	for (i = 0; i < n; i++)
+		wanted[i] = _mm256_set1_epi8(reject[i]);
+	for (;; p += 32)
+	{
+		v = _mm256_load_si256((const __m256i *)p);
+		hit = _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+		for (i = 0; i < n; i++)
+			hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, wanted[i]));
+		mask = (unsigned int)_mm256_movemask_epi8(hit);
+		if (p < s)
+			mask >>= s - p;
+		if (mask)
+			return (32 + (p < s ? 0 : (size_t)(p - s)) + __builtin_ctz(mask));
+	}
+}
+#endif /* STR_HAVE_X86 */
+
+/* ----------------------------- dispatch ----------------------------- */
+
+static size_t lenAuto(const char *s);
+static const char *chrAuto(const char *s, int c);
+static int cmpAuto(const char *a, const char *b);
+static size_t cspnAuto(const char *s, const char *reject);
+
+static const str_ops_t str_auto = {lenAuto, chrAuto, cmpAuto, cspnAuto};
+static const str_ops_t str_levels[] = {
+	{lenScalar, chrScalar, cmpScalar, cspnScalar},
+	{lenSwar, chrSwar, cmpSwar, cspnSwar},
+#ifdef STR_HAVE_X86
+	{lenSse2, chrSse2, cmpSse2, cspnSse2},
+	{lenAvx2, chrAvx2, cmpAvx2, cspnAvx2},
+#endif
+};
+static const str_ops_t *str_ops = &str_auto;
+static str_ops_t str_tuned; /* per function mix of levels, strKernelTune() */
+
+/**
+ * strKernelBest - picks the widest level this CPU supports
+ *
+ * Return: the level
+ */
+str_level_t strKernelBest(void)
+{
+#ifdef STR_HAVE_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return (STR_AVX2);
+	if (__builtin_cpu_supports("sse2"))
+		return (STR_SSE2);
+#endif
+	return (STR_SWAR);
+}
+
+/**
+ * strKernelSelect - makes every string function use one level
+ * @level: level to use
+ *
+ * Description: for the bench, which times the levels side by side; the
+ * shell itself runs the mix strKernelTune() picks.
+ *
+ * Return: 0 on success, -1 if the level is not available here
+ */
+int strKernelSelect(str_level_t level)
+{
+	if ((size_t)level >= sizeof(str_levels) / sizeof(str_levels[0]))
+		return (-1);
+#ifdef STR_HAVE_X86
+	__builtin_cpu_init();
+	if (level == STR_AVX2 && !__builtin_cpu_supports("avx2"))
+		return (-1);
+	if (level == STR_SSE2 && !__builtin_cpu_supports("sse2"))
+		return (-1);
+#endif
+	str_ops = &str_levels[level];
+	return (0);
+}
+
+/**
+ * strKernelTune - picks each function's level for this CPU, from the
+ * numbers of "make -C bench run"
+ *
+ * Description: the widest level wins everywhere except strcmp, where
+ * AVX2 runs about 2x slower than SSE2 on environment-sized strings: most
+ * compares end in the first bytes, and the wider block and its page
+ * check cost more than they save. strcspn keeps AVX2, it ties SSE2 on
+ * short words and is 2x faster on long spans.
+ */
+static void strKernelTune(void)
+{
+	str_level_t best = strKernelBest();
+
+	str_tuned = str_levels[best];
+#ifdef STR_HAVE_X86
+	if (best == STR_AVX2)
+		str_tuned.cmp = str_levels[STR_SSE2].cmp;
+#endif
+	str_ops = &str_tuned;
+}
+
+/**
+ * lenAuto - first call: picks the levels, then forwards
+ * @s: string
+ *
+ * Return: length of s
+ */
+static size_t lenAuto(const char *s)
+{
+	strKernelTune();
+	return (str_ops->len(s));
+}
+
+/**
+ * chrAuto - first call: picks the levels, then forwards
+ * @s: string
+ * @c: byte to find
+ *
+ * Return: first byte of s equal to c, or its terminating NUL
+ */
+static const char *chrAuto(const char *s, int c)
+{
+	strKernelTune();
+	return (str_ops->chr(s, c));
+}
+
+/**
+ * cmpAuto - first call: picks the levels, then forwards
+ * @a: 1st string
+ * @b: 2nd string
+ *
+ * Return: difference of the first differing chars, 0 if equal
+ */
+static int cmpAuto(const char *a, const char *b)
+{
+	strKernelTune();
+	return (str_ops->cmp(a, b));
+}
+
+/**
+ * cspnAuto - first call: picks the levels, then forwards
+ * @s: string
+ * @reject: bytes that end the span
+ *
+ * Return: length of the leading part of s without any byte of reject
+ */
+static size_t cspnAuto(const char *s, const char *reject)
+{
+	strKernelTune();
+	return (str_ops->cspn(s, reject));
+}
+
+/**
+ * strScanLen - length of s with the selected kernel
+ * @s: string
+ *
+ * Return: length of s
+ */
+size_t strScanLen(const char *s)
+{
+	return (str_ops->len(s));
+}
+
+/**
+ * strScanChr - first c or the end of s, with the selected kernel
+ * @s: string
+ * @c: byte to find
+ *
+ * Return: first byte of s equal to c, or its terminating NUL
+ */
+const char *strScanChr(const char *s, int c)
+{
+	return (str_ops->chr(s, c));
+}
+
+/**
+ * strScanCmp - strcmp with the selected kernel
+ * @a: 1st string
+ * @b: 2nd string
+ *
+ * Return: difference of the first differing chars, 0 if equal
+ */
+int strScanCmp(const char *a, const char *b)
+{
+	return (str_ops->cmp(a, b));
+}
+
+/**
+ * strScanCspn - strcspn with the selected kernel
+ * @s: string
+ * @reject: bytes that end the span
+ *
+ * Return: length of the leading part of s without any byte of reject
+ */
+size_t strScanCspn(const char *s, const char *reject)
+{
+	return (str_ops->cspn(s, reject));
+}
@@ -9,22 +9,7 @@
 */
 char *_strcat(char *dest, const char *src)
 {
-	int i = 0;
-	int j;
-
-	while (dest[i] != '\0')
-	{
-		i++;
-	}
-
-	for (j = 0; src[j] != '\0'; j++)
-	{
-		dest[i] = src[j];
-		i++;
-	}
-
-	dest[i] = '\0';
-
+	memcpy(dest + strScanLen(dest), src, strScanLen(src) + 1);
 	return (dest);
 }
 
@@ -37,18 +22,13 @@ char *_strcat(char *dest, const char *src)
 */
 char *_strchr(const char *s, char c)
 {
-	int i;
+	const char *found;
 
-	if ((s == NULL) || (_strlen(s) == 0))
+	if ((s == NULL) || (c == '\0')) /* the terminator is never "found" */
 		return (NULL);
 
-	for (i = 0; i < _strlen(s); i++)
-	{
-		if (s[i] == c)
-			return ((char *)&s[i]);
-	}
-
-	return (NULL);
+	found = strScanChr(s, c); /* one pass, stops at c or the end */
+	return (*found == c ? (char *)found : NULL);
 }
 /**
  * _strlen - returns the length of a string
@@ -58,16 +38,10 @@ char *_strchr(const char *s, char c)
  */
 int _strlen(const char *s)
 {
-	int count = 0;
-	int index;
-
 	if (s == NULL)
 		return (0);
 
-	for (index = 0; s[index] != '\0'; index++)
-		count++;
-
-	return (count);
+	return ((int)strScanLen(s));
 }
 
 /**
@@ -79,25 +53,7 @@ int _strlen(const char *s)
 */
 int _strcmp(const char *s1, const char *s2)
 {
-	int diff = 0;
-	int i;
-	int s1end = 1;
-	int s2end = 1;
-
-	for (i = 0; s1end != 0 && s2end != 0; i++)
-	{
-		if (s1[i] == '\0')
-			s1end = 0;
-		if (s2[i] == '\0')
-			s2end = 0;
-		if (s1[i] != s2[i])
-		{
-			diff += s1[i] - s2[i];
-			break;
-		}
-	}
-
-	return (diff);
+	return (strScanCmp(s1, s2));
 }
 
 /**
@@ -109,13 +65,6 @@ int _strcmp(const char *s1, const char *s2)
  */
 char *_strcpy(char *dest, const char *src)
 {
-	int i;
-
-	for (i = 0; src[i] != '\0'; i++)
-	{
-		dest[i] = src[i];
-	}
-	dest[i] = '\0';
-
+	memcpy(dest, src, strScanLen(src) + 1);
 	return (dest);
 }